@@ -22,6 +22,8 @@
 #include <QCursor>
 
 #include "map_data.hpp"
+#include "grid_graph.hpp"
+#include "layered_map.hpp"
 #include "map_helper.hpp"
 
 #include "pathworker.h"
@@ -49,8 +51,9 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
     void initialize_window();
-    void update_map(Map map);
-    void show_path(Map map, cell start, cell goal);
+    void update_map(const Map& map);
+    void update_map(const LayeredMap& map);
+    void show_path(const Map& map, cell start, cell goal);
     void clear_results();
     void update_results_view();
 
@@ -58,8 +61,9 @@ private:
     QCursor set_erase_cursor(int erase_size);
     void set_settings_enabled(bool is_enabled);
     void set_position_button(QPushButton *obj, bool is_enabled);
-    void update_pixmap(Map map, QImage* image);
-    void add_point_to_display(QString last_pos_str, QString pos_str);
+    QColor get_cell_color(int cell_val);
+    void update_pixmap(const LayeredMap& map, QImage* image);
+    void update_nav_points();
     bool eventFilter(QObject *object, QEvent *event);
 
     // UI Variables
@@ -69,9 +73,7 @@ private:
     QPixmap px_map;
     QColor empty_color = Qt::black;
     bool start_pos_click = false;
-    QString last_start_pos_str;
     bool goal_pos_click = false;
-    QString last_goal_pos_str;
     bool draw_click = false;
     bool erase_click = false;
     QPoint mouse_pos;
@@ -82,8 +84,14 @@ private:
     PathWorker *p_worker;
 
     // State Variables
-    Map obstacle_map, display_map;
-    Graph graph;
+    Map obstacle_map;
+    LayeredMap display_map;  // obstacle map with start and goal overlay
+    int nav_layer = 0;
+    shared_ptr<GridGraph> graph;
+    GraphSnapshot running_graph;  // graph shared with the worker thread
+    shared_ptr<DStarLite> d_star_lite;  // search state kept across runs
+    shared_ptr<HPAStar> hpa_star;       // cluster abstraction kept across runs
+    shared_ptr<ComponentLabels> components;  // connected components kept across runs
     bool debug = false;
     bool path_computed = false;
     bool map_uploaded = false;
@@ -104,6 +112,18 @@ private:
     const QString erase_cursor = ":/icons/cursor_eraser.svg";
     const QString bfs_id = "BFS";
     const QString a_star_id = "A*";
+    const QString dijkstra_id = "Dijkstra";
+    const QString jps_id = "JPS";
+    const QString adaptive_a_star_id = "Adaptive A*";
+    const QString alt_a_star_id = "ALT A*";
+    const QString bi_bfs_id = "Bidirectional BFS";
+    const QString bi_a_star_id = "Bidirectional A*";
+    const QString ara_star_id = "ARA*";
+    const QString ch_id = "Contraction Hierarchy";
+    const QString hpa_star_id = "HPA*";
+    const QString pyramid_id = "Pyramid Search";
+    const QString cost_to_go_id = "Cost-to-Go Field";
+    const QString d_star_lite_id = "D* Lite";
     const QString rrt_star_id = "RRT*";
     const QString all_id = "All";
 
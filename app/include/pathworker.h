@@ -2,6 +2,7 @@
 #define PATHWORKER_H
 
 #include <vector>
+#include <memory>
 
 #include <QObject>
 #include <QDebug>
@@ -9,6 +10,12 @@
 #include <QString>
 
 #include "map_data.hpp"
+#include "grid_graph.hpp"
+#include "d_star_lite.hpp"
+#include "hpa_star.hpp"
+#include "pyramid_search.hpp"
+#include "cost_to_go.hpp"
+#include "components.hpp"
 
 #include "map_helper.hpp"
 #include "time_helper.hpp"
@@ -20,9 +27,14 @@ public:
     explicit PathWorker(QObject *parent = nullptr);
     ~PathWorker();
     void send_timeout_error(QString& message);
+    void set_d_star_lite(shared_ptr<DStarLite> planner, const vector<CellRect>& edits);
+    void set_hpa_star(shared_ptr<HPAStar> planner, const vector<CellRect>& edits);
+    // Planner of the last run, built by the worker when none was set
+    shared_ptr<HPAStar> get_hpa_star() const { return hpa_star; }
+    void set_components(shared_ptr<const ComponentLabels> labels);
 
 public slots:
-    void compute_path(QString algo_name, Graph g, int max_iters);
+    void compute_path(QString algo_name, const GraphSnapshot& g, int max_iters);
 
 signals:
     void algo_progress(int completed);
@@ -30,16 +42,45 @@ signals:
     void compute_error(vector<AlgoResult> results, const QString& message);
 
 private:
-    void run_bfs(Graph g);
-    void run_a_star(Graph g);
-    void run_rrt_star(Graph g, int max_iters);
+    void run_bfs(const PlanningGraph& g);
+    void run_a_star(const PlanningGraph& g);
+    void run_dijkstra(const PlanningGraph& g);
+    void run_jps(const PlanningGraph& g);
+    void run_adaptive_a_star(const PlanningGraph& g);
+    void run_alt_a_star(const PlanningGraph& g);
+    void run_bidirectional_bfs(const PlanningGraph& g);
+    void run_bidirectional_a_star(const PlanningGraph& g);
+    void run_ara_star(const PlanningGraph& g);
+    void run_contraction_hierarchy(const PlanningGraph& g);
+    void run_hpa_star(const PlanningGraph& g);
+    void run_pyramid_search(const PlanningGraph& g);
+    void run_cost_to_go(const PlanningGraph& g);
+    void run_d_star_lite(const PlanningGraph& g);
+    void run_rrt_star(const PlanningGraph& g, int max_iters);
 
     QString bfs_id = "BFS";
     QString a_star_id = "A*";
+    QString dijkstra_id = "Dijkstra";
+    QString jps_id = "JPS";
+    QString adaptive_a_star_id = "Adaptive A*";
+    QString alt_a_star_id = "ALT A*";
+    QString bi_bfs_id = "Bidirectional BFS";
+    QString bi_a_star_id = "Bidirectional A*";
+    QString ara_star_id = "ARA*";
+    QString ch_id = "Contraction Hierarchy";
+    QString hpa_star_id = "HPA*";
+    QString pyramid_id = "Pyramid Search";
+    QString cost_to_go_id = "Cost-to-Go Field";
+    QString d_star_lite_id = "D* Lite";
     QString rrt_star_id = "RRT*";
     QString all_id = "All";
     int compute_timeout = 600000;  // in milliseconds (10 minutes)
     bool timeout_occurred = false;
+    shared_ptr<DStarLite> d_star_lite;  // owned by MainWindow between runs
+    vector<CellRect> d_star_edits;
+    shared_ptr<HPAStar> hpa_star;  // owned by MainWindow between runs
+    vector<CellRect> hpa_edits;
+    shared_ptr<const ComponentLabels> components;  // labels of the graph snapshot
 
 protected:
     vector<AlgoResult> results;
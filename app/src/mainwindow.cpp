@@ -25,7 +25,7 @@ MainWindow::~MainWindow(){
 
 void MainWindow::initialize_window(){
     // Initialize combobox for algorithms
-    QStringList algos_lst = {bfs_id, a_star_id, rrt_star_id, all_id};
+    QStringList algos_lst = {bfs_id, a_star_id, dijkstra_id, jps_id, adaptive_a_star_id, alt_a_star_id, bi_bfs_id, bi_a_star_id, ara_star_id, ch_id, hpa_star_id, pyramid_id, cost_to_go_id, d_star_lite_id, rrt_star_id, all_id};
     ui->cb_bx_algos->addItems(algos_lst);
     num_of_algos = algos_lst.size()-1;
 
@@ -38,14 +38,15 @@ void MainWindow::initialize_window(){
     image = new QImage(ui->view_map->width(), ui->view_map->height(), QImage::Format_RGB666);
     image->fill(Qt::white);
     this->scene->addPixmap(QPixmap::fromImage(*image));
+    nav_layer = display_map.add_layer();
 
     // Allow for mouse events on map display
     ui->view_map->setMouseTracking(true);
     ui->view_map->installEventFilter(this);
     scene->installEventFilter(this);
 
-    // Initialize color indexes for paths (only supports 7 paths)
-    vector<array<int,3>> colors = {{1,1,1}, {0,0,0},{255,255,255},{128,0,128},{173,216,230},{255,0,0}, {102,178,255}, {0,179,60}, {230,230,0}, {255,166,77}, {0,128,128}, {51,0,153}};
+    // Initialize color indexes for paths (only supports 15 paths)
+    vector<array<int,3>> colors = {{1,1,1}, {0,0,0},{255,255,255},{128,0,128},{173,216,230},{255,0,0}, {102,178,255}, {0,179,60}, {230,230,0}, {255,166,77}, {0,128,128}, {51,0,153}, {255,102,178}, {153,102,51}, {0,102,204}, {204,153,255}, {255,204,0}, {0,204,153}, {153,0,51}, {102,51,0}};
     int path_idx = -2;
     for(auto color: colors){
         color_idxs.push_back(ColorIdx{path_idx, color});
@@ -99,36 +100,40 @@ void MainWindow::set_settings_enabled(bool is_enabled){
 
 // MAP DISPLAY FUNCTIONS
 
-void MainWindow::update_pixmap(Map map, QImage *image){
+QColor MainWindow::get_cell_color(int cell_val){
+    int rgb[3] = {128, 128, 128};
+    for(int i = 0; i < color_idxs.size(); i++){
+        if(color_idxs[i].idx == cell_val) {
+            rgb[0] = color_idxs[i].rgb_vals[0];
+            rgb[1] = color_idxs[i].rgb_vals[1];
+            rgb[2] = color_idxs[i].rgb_vals[2];
+            break;
+        }
+    }
+    QColor color = QColor::fromRgb(rgb[0], rgb[1], rgb[2]);
+    return color.isValid() ? color : empty_color;
+}
+
+// Draws the base map, then the overlay cells on top of it
+void MainWindow::update_pixmap(const LayeredMap& map, QImage *image){
+    const Map& base = map.get_base();
     image->fill(empty_color);
-    for(int row = 0; row < map.px_height; row++){
-        for(int col = 0; col < map.px_width; col++){
-            int cell_val = map.boundaries[row][col];
-            int *rgb;
-            for(int i = 0; i < color_idxs.size(); i++){
-                if(color_idxs[i].idx == cell_val) {
-                    rgb = new int[3];
-                    rgb[0] = color_idxs[i].rgb_vals[0];
-                    rgb[1] = color_idxs[i].rgb_vals[1];
-                    rgb[2] = color_idxs[i].rgb_vals[2];
-                    break;
-                }
-                else if(color_idxs[i].idx != cell_val && i == color_idxs.size()-1){
-                    rgb = new int[3];
-                    rgb[0] = 128;
-                    rgb[1] = 128;
-                    rgb[2] = 128;
-                }
-            }
-            QColor color = QColor::fromRgb(rgb[0], rgb[1], rgb[2]);
-            if(color.isValid()) image->setPixelColor(col, row, color);
-            else image->setPixelColor(col, row, empty_color);
+    for(int row = 0; row < base.px_height; row++){
+        for(int col = 0; col < base.px_width; col++){
+            image->setPixelColor(col, row, this->get_cell_color(base.boundaries[row][col]));
         }
     }
+    for(auto& layer: map.get_layers()){
+        for(auto& oc: layer) image->setPixelColor(oc.col, oc.row, this->get_cell_color(oc.val));
+    }
 }
 
-void MainWindow::update_map(Map map){
-    image = new QImage(map.px_width, map.px_height, QImage::Format_RGB666);
+void MainWindow::update_map(const Map& map){
+    this->update_map(LayeredMap(map));
+}
+
+void MainWindow::update_map(const LayeredMap& map){
+    image = new QImage(map.get_width(), map.get_height(), QImage::Format_RGB666);
     this->update_pixmap(map, image);
     px_map = QPixmap::fromImage(*image).scaled(ui->view_map->width(),
                                                         ui->view_map->height(),
@@ -137,52 +142,45 @@ void MainWindow::update_map(Map map){
     this->scene->addPixmap(px_map);
 }
 
-void MainWindow::show_path(Map map, cell start, cell goal){
-    Map path_map = MapData::copy_map(display_map);
+// Results are drawn as overlays on the obstacle map, so only the path and
+// travelled cells are allocated
+void MainWindow::show_path(const Map& map, cell start, cell goal){
     if(results.empty()) return;
-    else if(results.size() == 1){
-        if(debug) path_map = MapData::debug_map(path_map, results[0].path, results[0].travelled, start, goal);
-        else path_map = MapData::add_path_to_map(path_map, results[0].path, start, goal);
+    LayeredMap path_map(map);
+    if(results.size() == 1){
+        path_map = display_map;
+        if(debug) path_map.add_cells(path_map.add_layer(), results[0].get_travelled(), MapData::TRAVELLED_INT);
+        path_map.add_path(path_map.add_layer(), results[0].get_path(), MapData::PATH_INT, MapData::PATH_SIZE);
     }
     else{
-        path_map = map;
         int path_idx = COLOR_PATH_IDX;
         for(auto r: results){
-            path_map = MapData::add_path_to_map_with_value(path_map, path_idx, r.path, graph.root, graph.end);
+            path_map.add_path(path_map.add_layer(), r.get_path(), path_idx, MapData::PATH_SIZE);
             for(int i = 0; i < color_idxs.size(); i++){
                 if(color_idxs[i].idx == path_idx) color_idxs[i].name = r.type;
             }
             path_idx++;
         }
     }
-    path_map.boundaries[start.second][start.first] = MapData::NAV_POINT_INT;
-    MapData::inflate_point(path_map, start, pt_size);
-    path_map.boundaries[goal.second][goal.first] = MapData::NAV_POINT_INT;
-    MapData::inflate_point(path_map, goal, pt_size);
+    int point_layer = path_map.add_layer();
+    path_map.add_point(point_layer, start, MapData::NAV_POINT_INT, pt_size);
+    path_map.add_point(point_layer, goal, MapData::NAV_POINT_INT, pt_size);
     this->update_map(path_map);
-    delete path_map.boundaries;
 }
 
-void MainWindow::add_point_to_display(QString last_pos_str, QString pos_str){
+// Start and goal points live in their own overlay, so moving a point never
+// touches the obstacle map
+void MainWindow::update_nav_points(){
     if(map_uploaded){
-        // Remove old point if applicable
-        if(!last_pos_str.isEmpty() && last_pos_str != pos_str){
-            auto last_pos = MapHelper::get_positon(last_pos_str.toStdString());
-            if(last_pos.first >= 0 && last_pos.first < display_map.px_width && last_pos.second >= 0 && last_pos.second < display_map.px_height){
-                display_map.boundaries[last_pos.second][last_pos.first] = MapData::OPEN_SPACE_INT;
-                MapData::inflate_point(display_map, last_pos, MapData::POINT_SIZE);
-            }
-        }
-
-        // Add new point
-        if(!pos_str.isEmpty()){
+        display_map.clear_layer(nav_layer);
+        for(auto pos_str: {ui->line_start_pos->text(), ui->line_goal_pos->text()}){
+            if(pos_str.isEmpty()) continue;
             auto pos = MapHelper::get_positon(pos_str.toStdString());
-            if(pos.first >= 0 && pos.first < display_map.px_width && pos.second >= 0 && pos.second < display_map.px_height){
-                display_map.boundaries[pos.second][pos.first] = MapData::NAV_POINT_INT;
-                MapData::inflate_point(display_map, pos, MapData::POINT_SIZE);
-                this->update_map(display_map);
+            if(pos.first >= 0 && pos.first < obstacle_map.px_width && pos.second >= 0 && pos.second < obstacle_map.px_height){
+                display_map.add_point(nav_layer, pos, MapData::NAV_POINT_INT, MapData::POINT_SIZE);
             }
         }
+        this->update_map(display_map);
     }
 }
 
@@ -211,35 +209,33 @@ bool MainWindow::eventFilter(QObject *object, QEvent *event){
 
             // WORKING CODE
             if(draw_click || erase_click){
+                CellRect edit_rect;
                 if(erase_click){
                     obstacle_map.boundaries[scaled_y][scaled_x] = MapData::OPEN_SPACE_INT;
                     MapData::inflate_point(obstacle_map, {scaled_x, scaled_y}, ui->sp_bx_erase_size->value());
+                    edit_rect = MapData::point_rect(obstacle_map, {scaled_x, scaled_y}, ui->sp_bx_erase_size->value());
                 }
                 else if(draw_click){
                     obstacle_map.boundaries[scaled_y][scaled_x] = MapData::OBSTACLE_INT;
                     MapData::inflate_point(obstacle_map, {scaled_x, scaled_y}, ui->sp_bx_draw_size->value());
+                    edit_rect = MapData::point_rect(obstacle_map, {scaled_x, scaled_y}, ui->sp_bx_draw_size->value());
                 }
-                // Update display map with start and goal position
-                display_map.boundaries = MapData::copy_boundaries(obstacle_map);
-                auto start_pos_str = ui->line_start_pos->text();
-                auto goal_pos_str = ui->line_goal_pos->text();
-                if(!start_pos_str.isEmpty()) this->add_point_to_display(start_pos_str, start_pos_str);
-                if(!goal_pos_str.isEmpty()) this->add_point_to_display(goal_pos_str, goal_pos_str);
-                if(start_pos_str.isEmpty() && goal_pos_str.isEmpty()) this->update_map(display_map);
+                MapData::mark_dirty(obstacle_map, edit_rect);
+
+                // Display map draws over the obstacle map, so it only needs a redraw
+                this->update_nav_points();
                 return true;
             }
             else if(start_pos_click){
                 ui->line_start_pos->setText(QString("%1,%2").arg(scaled_x).arg(scaled_y));
                 this->set_position_button(ui->btn_start_pos, false);
-                this->add_point_to_display(last_start_pos_str, ui->line_start_pos->text());
-                last_start_pos_str = ui->line_start_pos->text();
+                this->update_nav_points();
                 return true;
             }
             else if(goal_pos_click){
                 ui->line_goal_pos->setText(QString("%1,%2").arg(scaled_x).arg(scaled_y));
                 this->set_position_button(ui->btn_goal_pos, false);
-                this->add_point_to_display(last_goal_pos_str, ui->line_goal_pos->text());
-                last_goal_pos_str = ui->line_goal_pos->text();
+                this->update_nav_points();
                 return true;
             }
         }
@@ -253,10 +249,11 @@ void MainWindow::on_btn_upload_map_clicked(){
     auto filename = QFileDialog::getOpenFileName(this, tr("Import Map YAML"), tr(""));
     //QString filename = "../../resources/maps/example1.yaml";
     if(filename.endsWith(".yaml")) {
-        Map new_map = MapData::get_map(filename.toStdString());
-        this->update_map(new_map);
-        obstacle_map = new_map;
-        display_map = MapData::copy_map(new_map);
+        obstacle_map = MapData::get_map(filename.toStdString());
+        display_map.set_base(obstacle_map);
+        display_map.clear_layer(nav_layer);
+        this->update_map(display_map);
+        graph = make_shared<GridGraph>(obstacle_map);
         map_uploaded = true;
         draw_click = false;
         erase_click = false;
@@ -337,14 +334,9 @@ void MainWindow::on_sp_bx_inflate_valueChanged(int inflate_size){
     if(map_uploaded){
         obstacle_map.boundaries = MapData::remove_boundary_inflation(obstacle_map);
         obstacle_map.boundaries = MapData::inflate_boundaries(obstacle_map, inflate_size);
-        display_map.boundaries = MapData::copy_boundaries(obstacle_map);
+        MapData::mark_dirty(obstacle_map, CellRect{0, 0, obstacle_map.px_width, obstacle_map.px_height});
         ui->txt_results->setText(QString("Map obstacles inflated by %1.").arg(inflate_size));
-
-        QString start_pos_str = ui->line_start_pos->text();
-        QString goal_pos_str = ui->line_goal_pos->text();
-        if(!start_pos_str.isEmpty()) this->add_point_to_display(start_pos_str, start_pos_str);
-        if(!goal_pos_str.isEmpty()) this->add_point_to_display(goal_pos_str, goal_pos_str);
-        if(start_pos_str.isEmpty() && goal_pos_str.isEmpty()) this->update_map(obstacle_map);
+        this->update_nav_points();
         path_computed = false;
     }
 
@@ -356,13 +348,11 @@ void MainWindow::on_sp_bx_inflate_valueChanged(int inflate_size){
 }
 
 void MainWindow::on_line_start_pos_editingFinished(){
-    this->add_point_to_display(last_start_pos_str, ui->line_start_pos->text());
-    last_start_pos_str = ui->line_start_pos->text();
+    this->update_nav_points();
 }
 
 void MainWindow::on_line_goal_pos_editingFinished(){
-    this->add_point_to_display(last_goal_pos_str, ui->line_goal_pos->text());
-    last_goal_pos_str = ui->line_goal_pos->text();
+    this->update_nav_points();
 }
 
 void MainWindow::on_btn_start_pos_clicked(){
@@ -433,13 +423,13 @@ void MainWindow::on_ch_bx_debug_toggled(bool checked){
     debug = checked;
     if(path_computed){
         this->update_results_view();
-        this->show_path(obstacle_map, graph.root, graph.end);
+        this->show_path(obstacle_map, graph->root, graph->end);
     }
 }
 
 void MainWindow::handle_compute_path_finished(vector<AlgoResult> c_results){
     results = c_results;
-    this->show_path(obstacle_map, graph.root, graph.end);
+    this->show_path(obstacle_map, graph->root, graph->end);
     this->update_results_view();
     path_computed = true;
     this->set_settings_enabled(true);
@@ -456,8 +446,12 @@ void MainWindow::on_btn_run_algo_clicked(){
     start_pos = MapHelper::get_positon(ui->line_start_pos->text().toStdString());
     goal_pos = MapHelper::get_positon(ui->line_goal_pos->text().toStdString());
 
-    // Convert map to graph
-    if(map_uploaded) graph = MapData::get_graph_from_map(obstacle_map);
+    // View map as graph (only regions edited since the last run are rebuilt)
+    if(map_uploaded){
+        // Copy on write if a worker still shares the last snapshot
+        if(graph.use_count() > 1) graph = make_shared<GridGraph>(*graph);
+        graph->update(obstacle_map);
+    }
 
     // Run algorithm(s)
     if(!map_uploaded){
@@ -465,17 +459,17 @@ void MainWindow::on_btn_run_algo_clicked(){
         QMessageBox::critical(this, "Map Error ", "Map has not been uploaded yet. Please click the \"Upload Map\" button to retrieve a map.");
         this->set_settings_enabled(true);
     }
-    else if(!graph.is_node_valid(start_pos) || !graph.is_node_valid(goal_pos)){
+    else if(!graph->is_node_valid(start_pos) || !graph->is_node_valid(goal_pos)){
         string err_msg = "Error:\n";
-        if(!graph.is_node_valid(start_pos)) err_msg += "  - Start position is not valid\n";
-        if(!graph.is_node_valid(goal_pos)) err_msg += "  - Goal position is not valid\n";
+        if(!graph->is_node_valid(start_pos)) err_msg += "  - Start position is not valid\n";
+        if(!graph->is_node_valid(goal_pos)) err_msg += "  - Goal position is not valid\n";
         err_msg += "\nMake sure the position text field is not empty, is clear of obstacles, and in this format: \"int,int\"\n";
         ui->txt_results->setText(QString::fromStdString(err_msg));
         this->set_settings_enabled(true);
     }
     else{
-        graph.root = start_pos;
-        graph.end = goal_pos;
+        graph->root = start_pos;
+        graph->end = goal_pos;
 
         max_iters = ui->sp_bx_iterations->value();
         if(path_computed){
@@ -485,12 +479,44 @@ void MainWindow::on_btn_run_algo_clicked(){
         this->set_settings_enabled(false);
 
 
-        // Create thread for running path computation
+        // Create thread for running path computation on a read-only snapshot
+        running_graph = graph;
         worker_thread = new QThread;
         p_worker = new PathWorker();
+
+        // Component labels are patched with the edits since the last run so
+        // the worker can reject a disconnected start and goal right away
+        vector<CellRect> component_edits;
+        if(!components || !MapData::get_dirty_rects(obstacle_map, components->get_map_version(), component_edits)){
+            components = make_shared<ComponentLabels>(*graph);
+        }
+        else if(!component_edits.empty()) components->update(*graph, component_edits);
+        p_worker->set_components(components);
+
+        // D* Lite keeps its search between runs and only repairs the regions
+        // edited since then (a new map or lost edit history starts over)
+        if(algo_name == d_star_lite_id || algo_name == all_id){
+            vector<CellRect> edits;
+            if(!d_star_lite || !MapData::get_dirty_rects(obstacle_map, d_star_lite->get_map_version(), edits)){
+                d_star_lite = make_shared<DStarLite>(*graph);
+                edits.clear();
+            }
+            p_worker->set_d_star_lite(d_star_lite, edits);
+        }
+        // Likewise HPA* keeps its clusters and only rebuilds the edited ones.
+        // A full build is left to the worker so large maps do not freeze the
+        // window, and the planner is taken back once the thread finishes.
+        if(algo_name == hpa_star_id || algo_name == all_id){
+            vector<CellRect> edits;
+            if(!hpa_star || !MapData::get_dirty_rects(obstacle_map, hpa_star->get_map_version(), edits)){
+                hpa_star.reset();
+                edits.clear();
+            }
+            p_worker->set_hpa_star(hpa_star, edits);
+        }
         p_worker->moveToThread(worker_thread);
         connect(worker_thread, &QThread::started, p_worker, [this]{
-            p_worker->compute_path(algo_name, graph, max_iters);
+            p_worker->compute_path(algo_name, running_graph, max_iters);
         });
 
         // Set signal for MainWindow functions
@@ -533,9 +559,10 @@ void MainWindow::update_results_view(){
         sub_data += QString("Distance: %1 <br>").arg(r.dist);
         if(debug){
             sub_data += "Path Nodes: [ ";
-            for(int i = 0; i<r.path.size(); i++){
-                if(i == r.path.size()-1) sub_data += QString("  (%1,%2) ] <br> <br>").arg(r.path[i].first).arg(r.path[i].second);
-                else sub_data += QString("  (%1,%2) ").arg(r.path[i].first).arg(r.path[i].second);
+            auto path = r.get_path();
+            for(int i = 0; i<path.size(); i++){
+                if(i == path.size()-1) sub_data += QString("  (%1,%2) ] <br> <br>").arg(path[i].first).arg(path[i].second);
+                else sub_data += QString("  (%1,%2) ").arg(path[i].first).arg(path[i].second);
             }
         }
         if(results.size() == 1) data += sub_data;
@@ -557,10 +584,12 @@ void MainWindow::update_results_view(){
 
 void MainWindow::handle_thread_finished(){
     qDebug() << "Worker thread finished and cleaned up.";
+    if(p_worker->get_hpa_star()) hpa_star = p_worker->get_hpa_star();
     p_worker->deleteLater();
     //worker_thread->deleteLater();
     worker_thread->terminate();
     worker_thread->wait();
     p_worker = nullptr;
     worker_thread = nullptr;
+    running_graph.reset();
 }
@@ -4,6 +4,18 @@
 #include "time_helper.hpp"
 #include "bfs.hpp"
 #include "a_star.hpp"
+#include "dijkstra.hpp"
+#include "jps.hpp"
+#include "adaptive_a_star.hpp"
+#include "landmarks.hpp"
+#include "bidirectional_search.hpp"
+#include "ara_star.hpp"
+#include "contraction_hierarchy.hpp"
+#include "d_star_lite.hpp"
+#include "hpa_star.hpp"
+#include "pyramid_search.hpp"
+#include "cost_to_go.hpp"
+#include "components.hpp"
 #include "rrt_star.hpp"
 
 PathWorker::PathWorker(QObject *parent)
@@ -17,7 +29,7 @@ PathWorker::~PathWorker(){
 }
 
 // BFS algorithm module
-void PathWorker::run_bfs(Graph g){
+void PathWorker::run_bfs(const PlanningGraph& g){
     auto bfs = BFS(g);
     auto start_time = high_resolution_clock::now();
     bfs.solve(g.root, g.end, compute_timeout);
@@ -25,12 +37,12 @@ void PathWorker::run_bfs(Graph g){
     auto duration = duration_cast<milliseconds>(end_time-start_time);
     if(duration.count() >= compute_timeout) timeout_occurred = true;
     auto data = bfs.reconstruct_path(g.root, g.end);
-    MapHelper::add_result(results, bfs_id.toStdString(),duration.count(),
+    MapHelper::add_result(results, bfs_id.toStdString(),duration.count(), CellLayout(g.get_width(), g.get_height()),
                           data.first, bfs.get_travelled_nodes(), data.second);
 }
 
 // A* algorithm module
-void PathWorker::run_a_star(Graph g){
+void PathWorker::run_a_star(const PlanningGraph& g){
     auto as = AStar(g);
     auto start_time = high_resolution_clock::now();
     as.solve(g.root, g.end, compute_timeout);
@@ -38,12 +50,190 @@ void PathWorker::run_a_star(Graph g){
     auto duration = duration_cast<milliseconds>(end_time-start_time);
     if(duration.count() >= compute_timeout) timeout_occurred = true;
     auto data = as.reconstruct_path(g.root, g.end);
-    MapHelper::add_result(results, a_star_id.toStdString(),duration.count(),
+    MapHelper::add_result(results, a_star_id.toStdString(),duration.count(), CellLayout(g.get_width(), g.get_height()),
                           data.first, as.get_travelled_nodes(), data.second);
 }
 
+// Dijkstra algorithm module
+void PathWorker::run_dijkstra(const PlanningGraph& g){
+    auto dijkstra = Dijkstra(g);
+    auto start_time = high_resolution_clock::now();
+    dijkstra.solve(g.root, g.end, compute_timeout);
+    auto end_time = high_resolution_clock::now();
+    auto duration = duration_cast<milliseconds>(end_time-start_time);
+    if(duration.count() >= compute_timeout) timeout_occurred = true;
+    auto data = dijkstra.reconstruct_path(g.root, g.end);
+    MapHelper::add_result(results, dijkstra_id.toStdString(), duration.count(), CellLayout(g.get_width(), g.get_height()),
+                          data.first, dijkstra.get_travelled_nodes(), data.second);
+}
+
+// JPS algorithm module
+void PathWorker::run_jps(const PlanningGraph& g){
+    auto jps = JPS(g);
+    auto start_time = high_resolution_clock::now();
+    jps.solve(g.root, g.end, compute_timeout);
+    auto end_time = high_resolution_clock::now();
+    auto duration = duration_cast<milliseconds>(end_time-start_time);
+    if(duration.count() >= compute_timeout) timeout_occurred = true;
+    auto data = jps.reconstruct_path(g.root, g.end);
+    MapHelper::add_result(results, jps_id.toStdString(), duration.count(), CellLayout(g.get_width(), g.get_height()),
+                          data.first, jps.get_travelled_nodes(), data.second);
+}
+
+// Adaptive A* algorithm module (heuristics learned by earlier runs)
+void PathWorker::run_adaptive_a_star(const PlanningGraph& g){
+    auto adaptive = AdaptiveAStar(g);
+    auto start_time = high_resolution_clock::now();
+    adaptive.solve(g.root, g.end, compute_timeout);
+    auto end_time = high_resolution_clock::now();
+    auto duration = duration_cast<milliseconds>(end_time-start_time);
+    if(duration.count() >= compute_timeout) timeout_occurred = true;
+    auto data = adaptive.reconstruct_path(g.root, g.end);
+    MapHelper::add_result(results, adaptive_a_star_id.toStdString(), duration.count(), CellLayout(g.get_width(), g.get_height()),
+                          data.first, adaptive.get_travelled_nodes(), data.second);
+}
+
+// ALT A* algorithm module (landmarks are kept until the map changes)
+void PathWorker::run_alt_a_star(const PlanningGraph& g){
+    auto start_time = high_resolution_clock::now();
+    auto grid = dynamic_cast<const GridGraph*>(&g);
+    auto table = grid ? LandmarkTable::get_landmark_table(*grid) :
+                        make_shared<const LandmarkTable>(g, LandmarkTable::DEFAULT_LANDMARKS);
+    auto alt = ALTAStar(g, LandmarkHeuristic(table));
+    alt.solve(g.root, g.end, compute_timeout);
+    auto end_time = high_resolution_clock::now();
+    auto duration = duration_cast<milliseconds>(end_time-start_time);
+    if(duration.count() >= compute_timeout) timeout_occurred = true;
+    auto data = alt.reconstruct_path(g.root, g.end);
+    MapHelper::add_result(results, alt_a_star_id.toStdString(), duration.count(), CellLayout(g.get_width(), g.get_height()),
+                          data.first, alt.get_travelled_nodes(), data.second);
+}
+
+// Contraction hierarchy module (the hierarchy is kept until the map changes)
+void PathWorker::run_contraction_hierarchy(const PlanningGraph& g){
+    auto start_time = high_resolution_clock::now();
+    auto grid = dynamic_cast<const GridGraph*>(&g);
+    auto ch = grid ? ContractionHierarchy::get_contraction_hierarchy(*grid) : make_shared<const ContractionHierarchy>(g);
+    auto search = CHSearch(g, ch);
+    search.solve(g.root, g.end, compute_timeout);
+    auto end_time = high_resolution_clock::now();
+    auto duration = duration_cast<milliseconds>(end_time-start_time);
+    if(duration.count() >= compute_timeout) timeout_occurred = true;
+    auto data = search.reconstruct_path(g.root, g.end);
+    MapHelper::add_result(results, ch_id.toStdString(), duration.count(), CellLayout(g.get_width(), g.get_height()),
+                          data.first, search.get_travelled_nodes(), data.second);
+}
+
+// Bidirectional BFS algorithm module
+void PathWorker::run_bidirectional_bfs(const PlanningGraph& g){
+    auto bi_bfs = BidirectionalBFS(g);
+    auto start_time = high_resolution_clock::now();
+    bi_bfs.solve(g.root, g.end, compute_timeout);
+    auto end_time = high_resolution_clock::now();
+    auto duration = duration_cast<milliseconds>(end_time-start_time);
+    if(duration.count() >= compute_timeout) timeout_occurred = true;
+    auto data = bi_bfs.reconstruct_path(g.root, g.end);
+    MapHelper::add_result(results, bi_bfs_id.toStdString(), duration.count(), CellLayout(g.get_width(), g.get_height()),
+                          data.first, bi_bfs.get_travelled_nodes(), data.second);
+}
+
+// Bidirectional A* algorithm module
+void PathWorker::run_bidirectional_a_star(const PlanningGraph& g){
+    auto bi_as = BidirectionalAStar(g);
+    auto start_time = high_resolution_clock::now();
+    bi_as.solve(g.root, g.end, compute_timeout);
+    auto end_time = high_resolution_clock::now();
+    auto duration = duration_cast<milliseconds>(end_time-start_time);
+    if(duration.count() >= compute_timeout) timeout_occurred = true;
+    auto data = bi_as.reconstruct_path(g.root, g.end);
+    MapHelper::add_result(results, bi_a_star_id.toStdString(), duration.count(), CellLayout(g.get_width(), g.get_height()),
+                          data.first, bi_as.get_travelled_nodes(), data.second);
+}
+
+// ARA* algorithm module (keeps the best path found before the timeout)
+void PathWorker::run_ara_star(const PlanningGraph& g){
+    auto ara = ARAStar(g);
+    auto start_time = high_resolution_clock::now();
+    ara.solve(g.root, g.end, compute_timeout);
+    auto end_time = high_resolution_clock::now();
+    auto duration = duration_cast<milliseconds>(end_time-start_time);
+    if(duration.count() >= compute_timeout) timeout_occurred = true;
+    auto data = ara.reconstruct_path(g.root, g.end);
+    MapHelper::add_result(results, ara_star_id.toStdString(), duration.count(), CellLayout(g.get_width(), g.get_height()),
+                          data.first, ara.get_travelled_nodes(), data.second);
+}
+
+void PathWorker::set_d_star_lite(shared_ptr<DStarLite> planner, const vector<CellRect>& edits){
+    d_star_lite = planner;
+    d_star_edits = edits;
+}
+
+// D* Lite algorithm module (repairs the search of the previous run)
+void PathWorker::run_d_star_lite(const PlanningGraph& g){
+    if(!d_star_lite) d_star_lite = make_shared<DStarLite>(g);
+    auto start_time = high_resolution_clock::now();
+    d_star_lite->update_graph(g, d_star_edits);
+    d_star_lite->solve(g.root, g.end, compute_timeout);
+    auto end_time = high_resolution_clock::now();
+    auto duration = duration_cast<milliseconds>(end_time-start_time);
+    if(duration.count() >= compute_timeout) timeout_occurred = true;
+    auto data = d_star_lite->reconstruct_path(g.root, g.end);
+    MapHelper::add_result(results, d_star_lite_id.toStdString(), duration.count(), CellLayout(g.get_width(), g.get_height()),
+                          data.first, d_star_lite->get_travelled_nodes(), data.second);
+}
+
+void PathWorker::set_hpa_star(shared_ptr<HPAStar> planner, const vector<CellRect>& edits){
+    hpa_star = planner;
+    hpa_edits = edits;
+}
+
+void PathWorker::set_components(shared_ptr<const ComponentLabels> labels){
+    components = labels;
+}
+
+// HPA* algorithm module (rebuilds only the clusters edited since the last run)
+void PathWorker::run_hpa_star(const PlanningGraph& g){
+    if(!hpa_star) hpa_star = make_shared<HPAStar>(g);
+    auto start_time = high_resolution_clock::now();
+    hpa_star->update_graph(g, hpa_edits);
+    hpa_star->solve(g.root, g.end, compute_timeout);
+    auto end_time = high_resolution_clock::now();
+    auto duration = duration_cast<milliseconds>(end_time-start_time);
+    if(duration.count() >= compute_timeout) timeout_occurred = true;
+    auto data = hpa_star->reconstruct_path(g.root, g.end);
+    MapHelper::add_result(results, hpa_star_id.toStdString(), duration.count(), CellLayout(g.get_width(), g.get_height()),
+                          data.first, hpa_star->get_travelled_nodes(), data.second);
+}
+
+// Coarse-to-fine search over the occupancy pyramid (shared per map version, fetched before the timed search)
+void PathWorker::run_pyramid_search(const PlanningGraph& g){
+    auto pyramid = PyramidSearch(g);
+    auto start_time = high_resolution_clock::now();
+    pyramid.solve(g.root, g.end, compute_timeout);
+    auto end_time = high_resolution_clock::now();
+    auto duration = duration_cast<milliseconds>(end_time-start_time);
+    if(duration.count() >= compute_timeout) timeout_occurred = true;
+    auto data = pyramid.reconstruct_path(g.root, g.end);
+    MapHelper::add_result(results, pyramid_id.toStdString(), duration.count(), CellLayout(g.get_width(), g.get_height()),
+                          data.first, pyramid.get_travelled_nodes(), data.second);
+}
+
+// Descends the cost-to-go field of the goal, kept in the shared cache so
+// later runs to the same goal on the same map skip the field
+void PathWorker::run_cost_to_go(const PlanningGraph& g){
+    auto start_time = high_resolution_clock::now();
+    auto grid = dynamic_cast<const GridGraph*>(&g);
+    auto field = grid ? CostToGoCache::get_shared_cache()->get_field(*grid, g.end) : make_shared<const CostToGoField>(g, g.end);
+    auto data = field->descend(g, g.root);
+    auto end_time = high_resolution_clock::now();
+    auto duration = duration_cast<milliseconds>(end_time-start_time);
+    if(duration.count() >= compute_timeout) timeout_occurred = true;
+    MapHelper::add_result(results, cost_to_go_id.toStdString(), duration.count(), CellLayout(g.get_width(), g.get_height()),
+                          data.first, data.first, data.second);
+}
+
 // RRT* algorithm module
-void PathWorker::run_rrt_star(Graph g, int max_iters){
+void PathWorker::run_rrt_star(const PlanningGraph& g, int max_iters){
     auto rrt = RRTStar(g, max_iters);
     auto start_time = high_resolution_clock::now();
     rrt.solve(g.root, g.end, compute_timeout);
@@ -51,19 +241,25 @@ void PathWorker::run_rrt_star(Graph g, int max_iters){
     auto duration = duration_cast<milliseconds>(end_time-start_time);
     if(duration.count() >= compute_timeout) timeout_occurred = true;
     auto data = rrt.reconstruct_path(g.root, g.end);
-    MapHelper::add_result(results, rrt_star_id.toStdString(), duration.count(),
+    MapHelper::add_result(results, rrt_star_id.toStdString(), duration.count(), CellLayout(g.get_width(), g.get_height()),
                           data.first, rrt.get_travelled_nodes(), data.second);
 }
 
 // Compute path(s)
-void PathWorker::compute_path(QString algo_name, Graph g, int max_iters){
+void PathWorker::compute_path(QString algo_name, const GraphSnapshot& g, int max_iters){
     results.clear();
     QString err_msg;
     auto time_converted = TimeHelper::convert_from_ms(compute_timeout);
     int algos_finished = 0;
     emit algo_progress(algos_finished);
+    // No planner can connect cells of different components, so the query is
+    // rejected before any of them floods the start component
+    if(components && !components->connected(g->root, g->end)){
+        emit compute_error(results, "   - Start and goal are not connected, no path exists\n");
+        return;
+    }
     if(algo_name == bfs_id || algo_name == all_id){
-        this->run_bfs(g);
+        this->run_bfs(*g);
         if(timeout_occurred){
             err_msg += QString("   - BFS Computation exceeded %1 %2\n").arg(time_converted.first).arg(time_converted.second.c_str());
             timeout_occurred = false;
@@ -72,7 +268,7 @@ void PathWorker::compute_path(QString algo_name, Graph g, int max_iters){
         emit algo_progress(algos_finished);
     }
     if(algo_name ==  a_star_id || algo_name == all_id){
-        this->run_a_star(g);
+        this->run_a_star(*g);
         if(timeout_occurred){
             err_msg += QString("   - A* Computation exceeded %1 %2\n").arg(time_converted.first).arg(time_converted.second.c_str());
             timeout_occurred = false;
@@ -80,8 +276,116 @@ void PathWorker::compute_path(QString algo_name, Graph g, int max_iters){
         algos_finished++;
         emit algo_progress(algos_finished);
     }
+    if(algo_name == dijkstra_id || algo_name == all_id){
+        this->run_dijkstra(*g);
+        if(timeout_occurred){
+            err_msg += QString("   - Dijkstra Computation exceeded %1 %2\n").arg(time_converted.first).arg(time_converted.second.c_str());
+            timeout_occurred = false;
+        }
+        algos_finished++;
+        emit algo_progress(algos_finished);
+    }
+    if(algo_name == jps_id || algo_name == all_id){
+        this->run_jps(*g);
+        if(timeout_occurred){
+            err_msg += QString("   - JPS Computation exceeded %1 %2\n").arg(time_converted.first).arg(time_converted.second.c_str());
+            timeout_occurred = false;
+        }
+        algos_finished++;
+        emit algo_progress(algos_finished);
+    }
+    if(algo_name == adaptive_a_star_id || algo_name == all_id){
+        this->run_adaptive_a_star(*g);
+        if(timeout_occurred){
+            err_msg += QString("   - Adaptive A* Computation exceeded %1 %2\n").arg(time_converted.first).arg(time_converted.second.c_str());
+            timeout_occurred = false;
+        }
+        algos_finished++;
+        emit algo_progress(algos_finished);
+    }
+    if(algo_name == alt_a_star_id || algo_name == all_id){
+        this->run_alt_a_star(*g);
+        if(timeout_occurred){
+            err_msg += QString("   - ALT A* Computation exceeded %1 %2\n").arg(time_converted.first).arg(time_converted.second.c_str());
+            timeout_occurred = false;
+        }
+        algos_finished++;
+        emit algo_progress(algos_finished);
+    }
+    if(algo_name == bi_bfs_id || algo_name == all_id){
+        this->run_bidirectional_bfs(*g);
+        if(timeout_occurred){
+            err_msg += QString("   - Bidirectional BFS Computation exceeded %1 %2\n").arg(time_converted.first).arg(time_converted.second.c_str());
+            timeout_occurred = false;
+        }
+        algos_finished++;
+        emit algo_progress(algos_finished);
+    }
+    if(algo_name == bi_a_star_id || algo_name == all_id){
+        this->run_bidirectional_a_star(*g);
+        if(timeout_occurred){
+            err_msg += QString("   - Bidirectional A* Computation exceeded %1 %2\n").arg(time_converted.first).arg(time_converted.second.c_str());
+            timeout_occurred = false;
+        }
+        algos_finished++;
+        emit algo_progress(algos_finished);
+    }
+    if(algo_name == ara_star_id || algo_name == all_id){
+        this->run_ara_star(*g);
+        if(timeout_occurred){
+            err_msg += QString("   - ARA* Computation exceeded %1 %2 (best path found is shown)\n").arg(time_converted.first).arg(time_converted.second.c_str());
+            timeout_occurred = false;
+        }
+        algos_finished++;
+        emit algo_progress(algos_finished);
+    }
+    if(algo_name == ch_id || algo_name == all_id){
+        this->run_contraction_hierarchy(*g);
+        if(timeout_occurred){
+            err_msg += QString("   - Contraction Hierarchy Computation exceeded %1 %2\n").arg(time_converted.first).arg(time_converted.second.c_str());
+            timeout_occurred = false;
+        }
+        algos_finished++;
+        emit algo_progress(algos_finished);
+    }
+    if(algo_name == hpa_star_id || algo_name == all_id){
+        this->run_hpa_star(*g);
+        if(timeout_occurred){
+            err_msg += QString("   - HPA* Computation exceeded %1 %2\n").arg(time_converted.first).arg(time_converted.second.c_str());
+            timeout_occurred = false;
+        }
+        algos_finished++;
+        emit algo_progress(algos_finished);
+    }
+    if(algo_name == pyramid_id || algo_name == all_id){
+        this->run_pyramid_search(*g);
+        if(timeout_occurred){
+            err_msg += QString("   - Pyramid Search Computation exceeded %1 %2\n").arg(time_converted.first).arg(time_converted.second.c_str());
+            timeout_occurred = false;
+        }
+        algos_finished++;
+        emit algo_progress(algos_finished);
+    }
+    if(algo_name == cost_to_go_id || algo_name == all_id){
+        this->run_cost_to_go(*g);
+        if(timeout_occurred){
+            err_msg += QString("   - Cost-to-Go Field Computation exceeded %1 %2\n").arg(time_converted.first).arg(time_converted.second.c_str());
+            timeout_occurred = false;
+        }
+        algos_finished++;
+        emit algo_progress(algos_finished);
+    }
+    if(algo_name == d_star_lite_id || algo_name == all_id){
+        this->run_d_star_lite(*g);
+        if(timeout_occurred){
+            err_msg += QString("   - D* Lite Computation exceeded %1 %2\n").arg(time_converted.first).arg(time_converted.second.c_str());
+            timeout_occurred = false;
+        }
+        algos_finished++;
+        emit algo_progress(algos_finished);
+    }
     if(algo_name == rrt_star_id || algo_name == all_id){
-        this->run_rrt_star(g, max_iters);
+        this->run_rrt_star(*g, max_iters);
         if(timeout_occurred){
             err_msg += QString("   - RRT* Computation exceeded %1 %2\n").arg(time_converted.first).arg(time_converted.second.c_str());
             timeout_occurred = false;
@@ -1,30 +1,13 @@
 #ifndef A_STAR_HPP
 #define A_STAR_HPP
 
-#include <limits>
-#include <cmath>
-#include "map_data.hpp"
+#include "best_first_search.hpp"
 
-class AStar{
-    public:
-        AStar(Graph g);
-        void solve(cell sp, cell ep, int timeout);
-        pair<vector<cell>, float> reconstruct_path(cell sp, cell ep);
-        void print_map(string name, map<cell, float> map);
-        vector<cell> get_travelled_nodes();
+// A* with the euclidean distance to the goal and a 4-ary indexed heap
+typedef BestFirstSearch<HeapOpenList<4>, EuclideanHeuristic, 8, float> AStar;
 
-    private:
-        float get_f_score(cell p);
-        float euclidean_heuristic(cell a, cell b);
-        bool not_in_set(vector<cell> open_set, cell p);
-        cell get_min_f(vector<cell> &s);
-        Graph tree;
-        map<cell, float> dist;
-        map<cell, float> h;
-        map<cell, float> f;
-        map<cell, cell> parent;
-        vector<cell> travelled;
-        
-};
+// A* with the heuristic scaled by the weight given to the constructor
+// (paths are at most that many times longer than the shortest path)
+typedef AStar WeightedAStar;
 
-#endif // A_STAR_HPP
\ No newline at end of file
+#endif // A_STAR_HPP
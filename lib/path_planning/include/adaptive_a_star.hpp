@@ -0,0 +1,62 @@
+#ifndef ADAPTIVE_A_STAR_HPP
+#define ADAPTIVE_A_STAR_HPP
+
+#include <memory>
+#include <shared_mutex>
+#include "map_data.hpp"
+#include "grid_graph.hpp"
+#include "free_bitmap.hpp"
+#include "cell_layout.hpp"
+#include "indexed_heap.hpp"
+
+// Heuristic values learned for one goal on one map. Zero means nothing was
+// learned for the cell and the octile distance is used. Values only grow and
+// are raised in place: searches to the goal hold mutex shared while they read
+// them, and learning holds it exclusively for the closed cells only.
+struct LearnedHeuristic {
+    LearnedHeuristic(const GridGraph& g, cell goal)
+        : goal(goal), map_version(g.get_map_version()), h(g.get_width(), g.get_height(), 0) {}
+    bool matches(const GridGraph& g) const {
+        return g.get_map_version() == map_version && g.get_width() == h.get_layout().get_width() &&
+               g.get_height() == h.get_layout().get_height();
+    }
+    cell goal;
+    uint64_t map_version;
+    CellArray<int> h;
+    std::shared_mutex mutex;
+};
+
+// Adaptive A* (Koenig & Likhachev) on the 8-connected grid. After each
+// search every closed cell s learns h(s) = g(goal) - g(s), which stays
+// admissible and consistent, so repeated queries to the same goal expand
+// fewer cells. Values are kept per goal for the last MAX_GOALS goals and
+// dropped when the map changes. Paths have the same cost as A*.
+class AdaptiveAStar {
+    public:
+        AdaptiveAStar(const PlanningGraph& g);
+        void solve(cell sp, cell ep, int timeout);
+        pair<vector<cell>, float> reconstruct_path(cell sp, cell ep);
+        vector<cell> get_travelled_nodes();
+        static void clear_heuristics();
+        bool goal_reached = false;
+
+        static const size_t MAX_GOALS = 8;
+
+    private:
+        enum NodeState : uint8_t { UNSEEN, OPEN, CLOSED };
+        int get_heuristic(cell c, cell ep) const;
+        void learn(cell_id goal_id);
+        const PlanningGraph& tree;
+        const FreeBitmap* free_cells;
+        shared_ptr<LearnedHeuristic> learned;
+        CellLayout layout;
+        CellArray<int> dist;
+        CellArray<cell_id> parent;
+        CellArray<uint8_t> state;
+        IndexedHeap<> open_set;
+        vector<cell_id> travelled, closed;
+
+        static const int UNREACHED = std::numeric_limits<int>::max();
+};
+
+#endif // ADAPTIVE_A_STAR_HPP
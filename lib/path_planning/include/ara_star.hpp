@@ -0,0 +1,53 @@
+#ifndef ARA_STAR_HPP
+#define ARA_STAR_HPP
+
+#include "map_data.hpp"
+#include "grid_graph.hpp"
+#include "free_bitmap.hpp"
+#include "cell_layout.hpp"
+#include "indexed_heap.hpp"
+
+// Path published by ARA*. Its cost is at most bound times the shortest path.
+struct ARASolution {
+    float weight, bound, dist;
+    int time;  // in milliseconds since solve() started
+    vector<cell> path;
+};
+
+// Anytime Repairing A* (Likhachev, Gordon & Thrun) on the 8-connected grid.
+// Starts as weighted A* with a large heuristic weight to publish a path
+// quickly, then lowers the weight by weight_step and repairs the search
+// (cells improved after being closed are kept aside and reopened) until the
+// weight reaches 1 or the deadline passed to solve() is hit. The best path
+// found so far is always available.
+class ARAStar {
+    public:
+        ARAStar(const PlanningGraph& g, float initial_weight = 3, float weight_step = 0.5);
+        void solve(cell sp, cell ep, int deadline);
+        pair<vector<cell>, float> reconstruct_path(cell sp, cell ep);
+        vector<cell> get_travelled_nodes();
+        const vector<ARASolution>& get_solutions() const { return solutions; }
+        bool goal_reached = false;
+
+    private:
+        enum NodeState : uint8_t { UNSEEN, SEEN, OPEN, CLOSED, INCONS };
+        float get_key(cell_id id) const;
+        bool improve_path(std::chrono::high_resolution_clock::time_point start, int deadline);
+        void publish(int time);
+        const PlanningGraph& tree;
+        const FreeBitmap* free_cells;
+        float initial_weight, weight_step, weight;
+        cell goal;
+        cell_id start_id, goal_id;
+        CellLayout layout;
+        CellArray<int> dist;
+        CellArray<cell_id> parent;
+        CellArray<uint8_t> state;
+        IndexedHeap<> open_set;
+        vector<cell_id> travelled, closed, incons;
+        vector<ARASolution> solutions;
+
+        static const int UNREACHED = std::numeric_limits<int>::max();
+};
+
+#endif // ARA_STAR_HPP
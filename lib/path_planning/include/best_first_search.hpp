@@ -0,0 +1,240 @@
+#ifndef BEST_FIRST_SEARCH_HPP
+#define BEST_FIRST_SEARCH_HPP
+
+#include <limits>
+#include <cmath>
+#include <cstdlib>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "map_data.hpp"
+#include "grid_graph.hpp"
+#include "cell_layout.hpp"
+#include "ring_queue.hpp"
+#include "indexed_heap.hpp"
+#include "bucket_queue.hpp"
+
+// Open list policies. Each one queues cell ids by key (f = g + h) and breaks
+// ties on g where it can. LABEL_ON_PUSH marks lists whose nodes are final as
+// soon as they are discovered (FIFO order over unit steps), so the search
+// never relaxes a seen node and stops when the goal is discovered.
+struct FifoOpenList {
+    static const bool LABEL_ON_PUSH = true;
+    FifoOpenList(int width, int height) {}
+    bool empty() const { return q.empty(); }
+    size_t size() const { return q.size(); }
+    void push(cell_id id, float key, float g) { q.push(id); }
+    cell_id pop() { return q.pop(); }
+    RingQueue<cell_id> q;
+};
+
+template<int D = 4>
+struct HeapOpenList {
+    static const bool LABEL_ON_PUSH = false;
+    HeapOpenList(int width, int height) : heap(width, height) {}
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    cell_id top() const { return heap.top(); }
+    void push(cell_id id, float key, float g) { heap.push(id, key, g); }
+    cell_id pop() { return heap.pop(); }
+    IndexedHeap<D> heap;
+};
+
+// Needs integer keys (integer weights and heuristic); decreased keys leave
+// stale entries that the search skips once the node is closed
+struct BucketOpenList {
+    static const bool LABEL_ON_PUSH = false;
+    BucketOpenList(int width, int height) : q(2*MapData::DIR_WEIGHT[MAX_NEIGHBORS-1]) {}
+    bool empty() const { return q.empty(); }
+    size_t size() const { return q.size(); }
+    void push(cell_id id, float key, float g) { q.push(id, (int)key); }
+    cell_id pop() { int key; return q.pop(key); }
+    BucketQueue q;
+};
+
+// Heuristic policies (distance estimate from a to b in edge weight units)
+struct NoHeuristic {
+    static const bool IS_ZERO = true;
+    template<typename W> static W cost(cell a, cell b) { return 0; }
+};
+
+struct EuclideanHeuristic {
+    static const bool IS_ZERO = false;
+    template<typename W> static W cost(cell a, cell b) {
+        int dx = a.first - b.first, dy = a.second - b.second;
+        return (W)std::sqrt((float)(dx*dx + dy*dy));
+    }
+};
+
+// Exact cost on an empty 8-connected grid: max(dx,dy) straight steps with
+// min(dx,dy) of them turned into diagonals
+struct OctileHeuristic {
+    static const bool IS_ZERO = false;
+    template<typename W> static W cost(cell a, cell b) {
+        int dx = std::abs(a.first - b.first), dy = std::abs(a.second - b.second);
+        const int diagonal = MapData::DIR_WEIGHT[MAX_NEIGHBORS-1];
+        return (W)(std::max(dx, dy) + (diagonal-1)*std::min(dx, dy));
+    }
+};
+
+struct ManhattanHeuristic {
+    static const bool IS_ZERO = false;
+    template<typename W> static W cost(cell a, cell b) {
+        return (W)(std::abs(a.first - b.first) + std::abs(a.second - b.second));
+    }
+};
+
+// Calls visit(neighbor, weight) for each neighbor of c until it returns
+// true. On a GridGraph the neighbors are read straight from its free space
+// bitmap (no virtual call); other graphs go through
+// PlanningGraph::get_neighbors. Connectivity 4 drops diagonal moves.
+template<int Connectivity, typename Visit>
+inline void for_each_neighbor(const PlanningGraph& tree, const FreeBitmap* free_cells, cell c, Visit&& visit){
+    if(free_cells){
+        // Bits 0-3 of the neighbor mask are the straight moves
+        unsigned mask = free_cells->neighbor_mask(c.first, c.second);
+        if(Connectivity == 4) mask &= 0x0F;
+        while(mask){
+            int d = __builtin_ctz(mask);
+            mask &= mask-1;
+            if(visit(cell{c.first + MapData::DIR_DX[d], c.second + MapData::DIR_DY[d]}, MapData::DIR_WEIGHT[d])) return;
+        }
+    }
+    else{
+        for(auto n: tree.get_neighbors(c)){
+            if(Connectivity == 4 && n.first.first != c.first && n.first.second != c.second) continue;
+            if(visit(n.first, n.second)) return;
+        }
+    }
+}
+
+// Free space bitmap of g if it is a GridGraph
+inline const FreeBitmap* get_free_cells(const PlanningGraph& g){
+    auto grid = dynamic_cast<const GridGraph*>(&g);
+    return grid ? &grid->get_free_bitmap() : nullptr;
+}
+
+// Best-first grid search shared by BFS, Dijkstra and (weighted) A*. All
+// policies are compile-time parameters so every planner is its own tight
+// loop. heuristic_weight > 1 inflates the heuristic (weighted A*); closed
+// nodes are reopened when a cheaper path to them is found. Bucket open lists
+// only take a weight of 1, since inflated keys leave the bucket window.
+template<typename OpenList, typename Heuristic, int Connectivity = 8, typename Weight = float>
+class BestFirstSearch {
+    static_assert(Connectivity == 4 || Connectivity == 8, "Connectivity has to be 4 or 8");
+
+    public:
+        BestFirstSearch(const PlanningGraph& g, float heuristic_weight = 1)
+            : BestFirstSearch(g, Heuristic(), heuristic_weight) {}
+
+        // Heuristics with state (e.g. precomputed tables) are passed in
+        BestFirstSearch(const PlanningGraph& g, Heuristic heuristic, float heuristic_weight = 1)
+            : tree(g), layout(g.get_width(), g.get_height()), open_set(g.get_width(), g.get_height()),
+              heuristic(heuristic), heuristic_weight(heuristic_weight){
+            if(std::is_same<OpenList, BucketOpenList>::value && heuristic_weight != 1){
+                throw std::invalid_argument("Bucket open lists need a heuristic weight of 1");
+            }
+            int width = tree.get_width(), height = tree.get_height();
+            dist = CellArray<Weight>(width, height, UNREACHED);
+            parent = CellArray<cell_id>(width, height, cell_id());
+            state = CellArray<uint8_t>(width, height, UNSEEN);
+            free_cells = get_free_cells(g);
+        }
+
+        void solve(cell sp, cell ep, int timeout){
+            using namespace std::chrono;
+            if(!tree.is_node_valid(sp)) return;
+            cell_id start_id = layout.to_id(sp);
+            goal_id = layout.to_id(ep);
+            goal = ep;
+            dist[start_id] = 0;
+            state[start_id] = OPEN;
+            open_set.push(start_id, get_key(0, sp), 0);
+            goal_reached = start_id == goal_id;
+            int expanded = 0;
+            auto start = high_resolution_clock::now();
+            while(!open_set.empty() && !goal_reached){
+                if(++expanded % TIMEOUT_CHECK_INTERVAL == 0){
+                    auto now = high_resolution_clock::now();
+                    if(duration_cast<milliseconds>(now-start).count() >= timeout) break;
+                }
+                cell_id curr = open_set.pop();
+                if(!OpenList::LABEL_ON_PUSH){
+                    if(state[curr] == CLOSED) continue; // Stale entry of a lazy open list
+                    state[curr] = CLOSED;
+                    if(curr == goal_id){
+                        goal_reached = true;
+                        break;
+                    }
+                }
+                expand(curr);
+            }
+        }
+
+        pair<vector<cell>, float> reconstruct_path(cell sp, cell ep){
+            auto data = pair<vector<cell>, float>();
+            for(cell_id curr = layout.to_id(ep); curr.is_valid(); curr = parent[curr]){
+                data.first.push_back(layout.to_cell(curr));
+            }
+            std::reverse(data.first.begin(), data.first.end());
+            if(data.first[0] != sp) data.first = vector<cell>();
+            data.second = dist[ep] == UNREACHED ? std::numeric_limits<float>::infinity() : (float)dist[ep];
+            return data;
+        }
+
+        vector<cell> get_travelled_nodes(){
+            vector<cell> nodes;
+            nodes.reserve(travelled.size());
+            for(auto t: travelled) nodes.push_back(layout.to_cell(t));
+            return nodes;
+        }
+
+        bool goal_reached = false;
+
+    private:
+        enum NodeState : uint8_t { UNSEEN, OPEN, CLOSED };
+
+        float get_key(Weight g, cell c) const {
+            if(Heuristic::IS_ZERO) return g;
+            return g + heuristic_weight*heuristic.template cost<Weight>(c, goal);
+        }
+
+        void expand(cell_id curr){
+            for_each_neighbor<Connectivity>(tree, free_cells, layout.to_cell(curr),
+                [&](cell child, int w){ return relax(curr, child, w); });
+        }
+
+        // Returns true once the goal is labelled by a LABEL_ON_PUSH list
+        bool relax(cell_id curr, cell child, Weight w){
+            cell_id cp = layout.to_id(child);
+            Weight new_dist = dist[curr] + w;
+            if(OpenList::LABEL_ON_PUSH ? state[cp] != UNSEEN : new_dist >= dist[cp]) return false;
+            if(state[cp] == UNSEEN) travelled.push_back(cp);
+            dist[cp] = new_dist;
+            parent[cp] = curr;
+            state[cp] = OPEN;
+            open_set.push(cp, get_key(new_dist, child), new_dist);
+            if(OpenList::LABEL_ON_PUSH && cp == goal_id) goal_reached = true;
+            return goal_reached;
+        }
+
+        static constexpr Weight UNREACHED = std::numeric_limits<Weight>::has_infinity ?
+                                            std::numeric_limits<Weight>::infinity() : std::numeric_limits<Weight>::max();
+
+        const PlanningGraph& tree;
+        const FreeBitmap* free_cells;
+        CellLayout layout;
+        OpenList open_set;
+        Heuristic heuristic;
+        float heuristic_weight;
+        cell goal;
+        cell_id goal_id;
+        CellArray<Weight> dist;
+        CellArray<cell_id> parent;
+        CellArray<uint8_t> state;
+        vector<cell_id> travelled;
+};
+
+#endif // BEST_FIRST_SEARCH_HPP
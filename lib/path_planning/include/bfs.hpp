@@ -1,20 +1,10 @@
 #ifndef BFS_HPP
 #define BFS_HPP
 
-#include <map_data.hpp>
+#include "best_first_search.hpp"
 
-class BFS{
-    public:
-        BFS(Graph g);
-        void solve(cell sp, cell ep, int timeout);
-        pair<vector<cell>, float> reconstruct_path(pair<int, int> sp, pair<int, int> ep);
-        vector<cell> get_travelled_nodes();
-    private:
-        Graph tree;
-        map<cell, float> dist;
-        map<cell,bool> visited;
-        map<cell, cell> parent;
-        vector<cell> q;
-};
+// Breadth-first search: nodes are labelled when first discovered and the
+// search stops as soon as the goal is discovered
+typedef BestFirstSearch<FifoOpenList, NoHeuristic, 8, float> BFS;
 
-#endif // BSF_HPP
\ No newline at end of file
+#endif // BFS_HPP
@@ -0,0 +1,154 @@
+#ifndef BIDIRECTIONAL_SEARCH_HPP
+#define BIDIRECTIONAL_SEARCH_HPP
+
+#include <type_traits>
+
+#include "best_first_search.hpp"
+
+// Searches from the start and the goal at the same time over the same
+// (undirected) graph, always growing the side with the smaller open list.
+//
+// With a FIFO open list both sides expand whole BFS layers and the search
+// stops after the layer in which the two sides first meet.
+//
+// With a heap both sides are A* with the balanced potentials
+// p(v) = (h(v, goal) - h(v, start)) / 2 forward and -p(v) backward, which
+// stay consistent. Every time a side reaches a node labelled by the other
+// side the path through it becomes a candidate (best). No shorter path
+// exists once the two smallest keys sum to at least best, so the search
+// stops there and the path is as short as the A* path. The potentials are
+// only half as informed as the A* heuristic, so on grid maps this visits
+// about as many cells as A* (see the README).
+template<typename OpenList, typename Heuristic, int Connectivity = 8, typename Weight = float>
+class BidirectionalSearch {
+    static_assert(Connectivity == 4 || Connectivity == 8, "Connectivity has to be 4 or 8");
+    static_assert(!std::is_same<OpenList, BucketOpenList>::value, "Keys can be fractional or negative");
+
+    public:
+        BidirectionalSearch(const PlanningGraph& g)
+            : tree(g), layout(g.get_width(), g.get_height()), free_cells(get_free_cells(g)),
+              forward(g.get_width(), g.get_height(), 1), backward(g.get_width(), g.get_height(), -1) {}
+
+        void solve(cell sp, cell ep, int timeout){
+            using namespace std::chrono;
+            if(!tree.is_node_valid(sp) || !tree.is_node_valid(ep)) return;
+            start = sp;
+            goal = ep;
+            forward.label(layout.to_id(sp), 0, cell_id(), get_potential(sp));
+            backward.label(layout.to_id(ep), 0, cell_id(), -get_potential(ep));
+            if(sp == ep) meet(layout.to_id(sp), 0);
+            auto start_time = high_resolution_clock::now();
+            int expanded = 0;
+            while(!forward.open_set.empty() && !backward.open_set.empty()){
+                if(++expanded % TIMEOUT_CHECK_INTERVAL == 0){
+                    auto now = high_resolution_clock::now();
+                    if(duration_cast<milliseconds>(now-start_time).count() >= timeout) break;
+                }
+                bool grow_forward = forward.open_set.size() <= backward.open_set.size();
+                Side& a = grow_forward ? forward : backward;
+                Side& b = grow_forward ? backward : forward;
+                if constexpr(OpenList::LABEL_ON_PUSH){
+                    if(goal_reached) break;
+                    for(size_t layer = a.open_set.size(); layer > 0; layer--) expand(a.open_set.pop(), a, b);
+                }
+                else{
+                    cell_id fa = forward.open_set.top(), fb = backward.open_set.top();
+                    if(get_key(forward, fa) + get_key(backward, fb) >= best) break;
+                    cell_id curr = a.open_set.pop();
+                    a.state[curr] = CLOSED;
+                    expand(curr, a, b);
+                }
+            }
+        }
+
+        pair<vector<cell>, float> reconstruct_path(cell sp, cell ep){
+            auto data = pair<vector<cell>, float>();
+            data.second = std::numeric_limits<float>::infinity();
+            if(!meet_id.is_valid()) return data;
+            for(cell_id curr = meet_id; curr.is_valid(); curr = forward.parent[curr]){
+                data.first.push_back(layout.to_cell(curr));
+            }
+            std::reverse(data.first.begin(), data.first.end());
+            for(cell_id curr = backward.parent[meet_id]; curr.is_valid(); curr = backward.parent[curr]){
+                data.first.push_back(layout.to_cell(curr));
+            }
+            data.second = best;
+            return data;
+        }
+
+        vector<cell> get_travelled_nodes(){
+            vector<cell> nodes;
+            nodes.reserve(travelled.size());
+            for(auto t: travelled) nodes.push_back(layout.to_cell(t));
+            return nodes;
+        }
+
+        bool goal_reached = false;
+
+    private:
+        enum NodeState : uint8_t { UNSEEN, OPEN, CLOSED };
+
+        struct Side {
+            Side(int width, int height, float sign)
+                : open_set(width, height), dist(width, height, UNREACHED), parent(width, height, cell_id()),
+                  state(width, height, UNSEEN), sign(sign) {}
+
+            void label(cell_id id, Weight d, cell_id from, float potential){
+                dist[id] = d;
+                parent[id] = from;
+                state[id] = OPEN;
+                open_set.push(id, d + potential, d);
+            }
+
+            OpenList open_set;
+            CellArray<Weight> dist;
+            CellArray<cell_id> parent;
+            CellArray<uint8_t> state;
+            float sign;  // 1 searching from the start, -1 from the goal
+        };
+
+        float get_potential(cell c) const {
+            if(Heuristic::IS_ZERO) return 0;
+            return (Heuristic::template cost<float>(c, goal) - Heuristic::template cost<float>(c, start))/2;
+        }
+
+        float get_key(const Side& side, cell_id id) const {
+            return side.dist[id] + side.sign*get_potential(layout.to_cell(id));
+        }
+
+        void meet(cell_id id, float cost){
+            best = cost;
+            meet_id = id;
+            goal_reached = true;
+        }
+
+        void expand(cell_id curr, Side& a, Side& b){
+            for_each_neighbor<Connectivity>(tree, free_cells, layout.to_cell(curr), [&](cell child, int w){
+                cell_id cp = layout.to_id(child);
+                Weight new_dist = a.dist[curr] + w;
+                if(OpenList::LABEL_ON_PUSH ? a.state[cp] != UNSEEN : new_dist >= a.dist[cp]) return false;
+                if(a.state[cp] == UNSEEN && b.state[cp] == UNSEEN) travelled.push_back(cp);
+                a.label(cp, new_dist, curr, a.sign*get_potential(child));
+                if(b.state[cp] != UNSEEN && new_dist + b.dist[cp] < best) meet(cp, new_dist + b.dist[cp]);
+                return false;
+            });
+        }
+
+        static constexpr Weight UNREACHED = std::numeric_limits<Weight>::has_infinity ?
+                                            std::numeric_limits<Weight>::infinity() : std::numeric_limits<Weight>::max();
+
+        const PlanningGraph& tree;
+        CellLayout layout;
+        const FreeBitmap* free_cells;
+        Side forward, backward;
+        cell start, goal;
+        cell_id meet_id;
+        float best = std::numeric_limits<float>::infinity();
+        vector<cell_id> travelled;
+};
+
+// Bidirectional BFS and A* (same heuristic as AStar)
+typedef BidirectionalSearch<FifoOpenList, NoHeuristic, 8, float> BidirectionalBFS;
+typedef BidirectionalSearch<HeapOpenList<4>, EuclideanHeuristic, 8, float> BidirectionalAStar;
+
+#endif // BIDIRECTIONAL_SEARCH_HPP
@@ -0,0 +1,53 @@
+#ifndef BUCKET_QUEUE_HPP
+#define BUCKET_QUEUE_HPP
+
+#include <vector>
+#include <stdexcept>
+
+#include "cell_layout.hpp"
+
+// Monotone integer priority queue over a circular array of buckets (Dial's
+// algorithm). Every key pushed has to lie in [min_key, min_key + max_spread],
+// which holds for Dijkstra with integer weights up to max_spread and for A*
+// with a consistent integer heuristic (f grows by at most 2 * max weight per
+// step). Push and pop are O(1) amortized. Entries are never removed, so a
+// decreased key leaves a stale entry behind that the caller skips on pop.
+class BucketQueue {
+    public:
+        BucketQueue(int max_spread = 8){
+            int n = 1;
+            while(n <= max_spread) n <<= 1;
+            buckets.resize(n);
+            mask = n-1;
+        }
+
+        bool empty() const { return count == 0; }
+        size_t size() const { return count; }
+
+        // An empty queue moves its window up to the key pushed (the start
+        // node of A* is pushed with its heuristic as key)
+        void push(cell_id id, int key){
+            if(count == 0 && key > current+mask) current = key;
+            if(key < current || key > current+mask) throw std::out_of_range("Key outside of bucket queue window");
+            buckets[key & mask].push_back(id);
+            count++;
+        }
+
+        // Removes an entry with the smallest key and stores that key in key
+        cell_id pop(int& key){
+            while(buckets[current & mask].empty()) current++;
+            auto& bucket = buckets[current & mask];
+            cell_id id = bucket.back();
+            bucket.pop_back();
+            count--;
+            key = current;
+            return id;
+        }
+
+    private:
+        std::vector<std::vector<cell_id>> buckets;
+        int mask = 0, current = 0;
+        size_t count = 0;
+};
+
+#endif // BUCKET_QUEUE_HPP
@@ -0,0 +1,175 @@
+#ifndef CELL_LAYOUT_HPP
+#define CELL_LAYOUT_HPP
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+
+#include "map_data.hpp"
+
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
+// Memory layouts for per-cell arrays, selected at compile time with
+// RPP_CELL_LAYOUT (see the RPP_CELL_LAYOUT CMake cache variable)
+#define RPP_LAYOUT_ROW_MAJOR 0
+#define RPP_LAYOUT_MORTON 1
+#define RPP_LAYOUT_TILED 2
+
+#ifndef RPP_CELL_LAYOUT
+#define RPP_CELL_LAYOUT RPP_LAYOUT_ROW_MAJOR
+#endif
+
+// Strongly typed 32-bit linear cell id, the slot of a cell in CellLayout order
+struct cell_id {
+    static const uint32_t INVALID = 0xFFFFFFFF;
+    uint32_t v = INVALID;
+
+    cell_id() {}
+    explicit cell_id(uint32_t v) : v(v) {}
+    bool is_valid() const { return v != INVALID; }
+    bool operator==(cell_id other) const { return v == other.v; }
+    bool operator!=(cell_id other) const { return v != other.v; }
+    bool operator<(cell_id other) const { return v < other.v; }
+};
+
+namespace std {
+    template<> struct hash<cell_id> {
+        size_t operator()(cell_id id) const { return id.v; }
+    };
+}
+
+// Maps (col,row) to a slot in a per-cell array.
+//  - ROW_MAJOR: row*width + col
+//  - MORTON:    32x32 blocks stored row-major, Z-order inside each block
+//  - TILED:     8x8 tiles stored row-major, row-major inside each tile
+// Blocking keeps vertical and diagonal neighbors close in memory while
+// bounding the padding to less than one block per row/column.
+class CellLayout {
+    public:
+        static const int BLOCK_BITS = RPP_CELL_LAYOUT == RPP_LAYOUT_MORTON ? 5 : 3;
+        static const int BLOCK_MASK = (1 << BLOCK_BITS) - 1;
+
+        CellLayout() {}
+        CellLayout(int width, int height) : width(width), height(height){
+            blocks_per_row = (width + BLOCK_MASK) >> BLOCK_BITS;
+            blocks_per_col = (height + BLOCK_MASK) >> BLOCK_BITS;
+        }
+
+        int index(int col, int row) const {
+#if RPP_CELL_LAYOUT == RPP_LAYOUT_ROW_MAJOR
+            return row*width + col;
+#else
+            int block = (row >> BLOCK_BITS)*blocks_per_row + (col >> BLOCK_BITS);
+            return block << (2*BLOCK_BITS) | block_offset(col & BLOCK_MASK, row & BLOCK_MASK);
+#endif
+        }
+
+        int index(cell c) const { return index(c.first, c.second); }
+
+        cell_id to_id(cell c) const { return cell_id(index(c.first, c.second)); }
+        cell to_cell(cell_id id) const { return to_cell((int)id.v); }
+        bool in_bounds(cell c) const {
+            return c.first >= 0 && c.first < width && c.second >= 0 && c.second < height;
+        }
+
+        cell to_cell(int idx) const {
+#if RPP_CELL_LAYOUT == RPP_LAYOUT_ROW_MAJOR
+            return cell{idx % width, idx / width};
+#else
+            int block = idx >> (2*BLOCK_BITS);
+            int offset = idx & ((1 << 2*BLOCK_BITS) - 1);
+            int col = (block % blocks_per_row) << BLOCK_BITS;
+            int row = (block / blocks_per_row) << BLOCK_BITS;
+#if RPP_CELL_LAYOUT == RPP_LAYOUT_MORTON
+            return cell{col | compact_bits(offset), row | compact_bits(offset >> 1)};
+#else
+            return cell{col | (offset & BLOCK_MASK), row | (offset >> BLOCK_BITS)};
+#endif
+#endif
+        }
+
+        // Number of slots needed (includes block padding)
+        int size() const {
+#if RPP_CELL_LAYOUT == RPP_LAYOUT_ROW_MAJOR
+            return width*height;
+#else
+            return (blocks_per_row*blocks_per_col) << (2*BLOCK_BITS);
+#endif
+        }
+
+        int get_width() const { return width; }
+        int get_height() const { return height; }
+
+        static const char* name(){
+#if RPP_CELL_LAYOUT == RPP_LAYOUT_MORTON
+            return "morton";
+#elif RPP_CELL_LAYOUT == RPP_LAYOUT_TILED
+            return "tiled";
+#else
+            return "row-major";
+#endif
+        }
+
+    private:
+        static int block_offset(int col, int row){
+#if RPP_CELL_LAYOUT == RPP_LAYOUT_MORTON
+            return spread_bits(col) | spread_bits(row) << 1;
+#else
+            return row << BLOCK_BITS | col;
+#endif
+        }
+
+        // Moves bit i of x to bit 2i
+        static uint32_t spread_bits(uint32_t x){
+#ifdef __BMI2__
+            return _pdep_u32(x, 0x55555555);
+#else
+            x = (x | (x << 8)) & 0x00FF00FF;
+            x = (x | (x << 4)) & 0x0F0F0F0F;
+            x = (x | (x << 2)) & 0x33333333;
+            x = (x | (x << 1)) & 0x55555555;
+            return x;
+#endif
+        }
+
+        // Moves bit 2i of x to bit i
+        static uint32_t compact_bits(uint32_t x){
+#ifdef __BMI2__
+            return _pext_u32(x, 0x55555555);
+#else
+            x &= 0x55555555;
+            x = (x | (x >> 1)) & 0x33333333;
+            x = (x | (x >> 2)) & 0x0F0F0F0F;
+            x = (x | (x >> 4)) & 0x00FF00FF;
+            x = (x | (x >> 8)) & 0x0000FFFF;
+            return x;
+#endif
+        }
+
+        int width = 0, height = 0;
+        int blocks_per_row = 0, blocks_per_col = 0;
+};
+
+// Dense per-cell array (dist, parent, visited, ...) stored in CellLayout order
+template<typename T>
+class CellArray {
+    public:
+        CellArray() {}
+        CellArray(int width, int height, T init) : layout(width, height), data(layout.size(), init) {}
+
+        T& operator[](cell c) { return data[layout.index(c.first, c.second)]; }
+        const T& operator[](cell c) const { return data[layout.index(c.first, c.second)]; }
+        T& operator[](cell_id id) { return data[id.v]; }
+        const T& operator[](cell_id id) const { return data[id.v]; }
+        void fill(T val) { std::fill(data.begin(), data.end(), val); }
+        const CellLayout& get_layout() const { return layout; }
+
+    private:
+        CellLayout layout;
+        std::vector<T> data;
+};
+
+#endif // CELL_LAYOUT_HPP
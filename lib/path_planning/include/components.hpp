@@ -0,0 +1,55 @@
+#ifndef COMPONENTS_HPP
+#define COMPONENTS_HPP
+
+#include <memory>
+#include "map_data.hpp"
+#include "free_bitmap.hpp"
+
+// Connected components of the free cells under the 8-connected moves of
+// GridGraph (diagonals may cut corners), as one label per cell. Labels come
+// from a scanline pass: each worker joins the runs of free cells of a band of
+// rows with union-find, then the bands are joined along their borders. Two
+// cells are connected iff they share a label, so a query between components
+// is rejected in O(1) instead of flooding the start component. update()
+// relabels only the components that touch the edited regions (or the whole
+// map when those are large).
+class ComponentLabels {
+    public:
+        ComponentLabels(const PlanningGraph& g);
+        // Labels stored by serialize(); nullptr if the data does not fit g
+        static shared_ptr<ComponentLabels> deserialize(const void* data, size_t size, const PlanningGraph& g);
+        vector<char> serialize() const;
+
+        // Relabels after g was edited in changed; returns the number of cells relabeled
+        int update(const PlanningGraph& g, const vector<CellRect>& changed);
+
+        uint32_t get_label(cell c) const {
+            if(c.first < 0 || c.first >= width || c.second < 0 || c.second >= height) return NO_COMPONENT;
+            return labels[(size_t)c.second*width + c.first];
+        }
+        bool connected(cell a, cell b) const {
+            uint32_t label = get_label(a);
+            return label != NO_COMPONENT && label == get_label(b);
+        }
+        int get_num_components() const { return num_components; }
+        uint64_t get_map_version() const { return map_version; }
+
+        static constexpr uint32_t NO_COMPONENT = 0xFFFFFFFF;
+        // update() floods at most 1/FLOOD_BUDGET_FRACTION of the map
+        static const int FLOOD_BUDGET_FRACTION = 16;
+
+    private:
+        ComponentLabels() {}
+        void bind(const PlanningGraph& g);
+        void label_all();
+        bool is_free(int col, int row) const;
+
+        const PlanningGraph* tree = nullptr;
+        const FreeBitmap* free_cells = nullptr;
+        uint64_t map_version = 0;
+        int width = 0, height = 0, num_components = 0;
+        uint32_t next_label = 0;   // labels of new components start here
+        vector<uint32_t> labels;   // row-major, NO_COMPONENT on blocked cells
+};
+
+#endif // COMPONENTS_HPP
@@ -0,0 +1,106 @@
+#ifndef CONTRACTION_HIERARCHY_HPP
+#define CONTRACTION_HIERARCHY_HPP
+
+#include <memory>
+#include "map_data.hpp"
+#include "grid_graph.hpp"
+
+// Contraction hierarchy (Geisberger et al.) over a reduced graph of a static
+// map. Free space is first split into rectangles; since a diagonal move
+// costs two straight ones, a shortest path never needs the inside of a
+// rectangle (crossing it straight and following its border is as short), so
+// only border cells become nodes, linked by their grid moves plus straight
+// edges across each rectangle. Cells inside a rectangle are reached by a
+// straight line from the four borders.
+// Nodes are contracted one by one in order of edge difference; each
+// contraction adds a shortcut between two of the node's neighbors unless a
+// bounded witness search finds a path around it that is no longer. Nodes are
+// numbered by contraction order and only upward edges (to later nodes) are
+// kept, in CSR form. Contraction stops once the remaining nodes average
+// CORE_DEGREE edges; that core keeps its edges in both directions and is
+// searched like plain Dijkstra. Shortcuts remember the node they skip so
+// paths can be unpacked back into grid cells.
+class ContractionHierarchy {
+    public:
+        struct Edge {
+            int32_t target, weight, middle;  // middle is -1 for straight lines
+        };
+
+        ContractionHierarchy(const PlanningGraph& g);
+        // Hierarchy stored by serialize(); nullptr if the data does not fit g
+        static shared_ptr<ContractionHierarchy> deserialize(const void* data, size_t size, const PlanningGraph& g);
+        vector<char> serialize() const;
+
+        // Node of a border cell, -1 for other cells
+        int get_node(cell c) const {
+            int r = get_rect(c);
+            return r < 0 ? -1 : node_of[(size_t)c.second*width + c.first];
+        }
+        // Rectangle of a free cell, -1 for blocked cells
+        int get_rect(cell c) const {
+            if(c.first < 0 || c.first >= width || c.second < 0 || c.second >= height) return -1;
+            return rect_of[(size_t)c.second*width + c.first];
+        }
+        // Nodes a free cell reaches in a straight line with their distance
+        void get_access_nodes(cell c, vector<pair<int, int>>& nodes) const;
+        cell get_cell(int node) const { return node_cells[node]; }
+        int get_num_nodes() const { return node_cells.size(); }
+        int get_num_rects() const { return rects.size(); }
+        int get_num_core() const { return num_core; }
+        size_t get_num_shortcuts() const { return num_shortcuts; }
+        const Edge* edges_begin(int node) const { return &edges[offsets[node]]; }
+        const Edge* edges_end(int node) const { return &edges[offsets[node+1]]; }
+        // Appends the cells of edge (a,b) after a, ending with b
+        void unpack(int a, int b, vector<cell>& path) const;
+        // True if the rectangles cover exactly the free cells
+        bool matches(const FreeBitmap& free_cells) const;
+
+        // Hierarchy of the last GridGraph asked for; contraction takes seconds
+        // on a real map, so it is only redone when the map version changes and
+        // matches() no longer holds
+        static shared_ptr<const ContractionHierarchy> get_contraction_hierarchy(const GridGraph& g);
+
+        // Cells settled by a witness search before it gives up
+        static const int WITNESS_LIMIT = 256;
+        // Average degree of the remaining nodes at which contraction stops
+        static const int CORE_DEGREE = 24;
+
+    private:
+        ContractionHierarchy() {}
+        void build_index();
+        int width = 0, height = 0, num_core = 0;
+        size_t num_shortcuts = 0;
+        vector<CellRect> rects;
+        vector<cell> node_cells;     // cell of each node (in contraction order)
+        vector<int32_t> rect_of;     // rectangle of each cell (row-major), -1 if blocked
+        vector<int32_t> node_of;     // node of each cell (row-major), -1 inside rectangles
+        vector<int32_t> offsets;     // upward edges of node i: edges[offsets[i], offsets[i+1])
+        vector<Edge> edges;
+};
+
+// Appends the cells of the straight (or staircase) line a-b after a
+void append_line(cell a, cell b, vector<cell>& path);
+
+// Point-to-point queries on a ContractionHierarchy: Dijkstra upwards from
+// the access nodes of the start and of the goal, stopping once neither side
+// can beat the best meeting node. Search arrays are reset by the nodes touched, so a search
+// object answers repeated queries without clearing whole-map arrays.
+class CHSearch {
+    public:
+        CHSearch(const PlanningGraph& g, shared_ptr<const ContractionHierarchy> ch);
+        void solve(cell sp, cell ep, int timeout);
+        pair<vector<cell>, float> reconstruct_path(cell sp, cell ep);
+        vector<cell> get_travelled_nodes();
+        bool goal_reached = false;
+
+    private:
+        shared_ptr<const ContractionHierarchy> ch;
+        vector<int32_t> dist[2], parent[2];
+        vector<int32_t> touched;
+        vector<pair<int, int>> access;
+        int meet = -1;
+        bool same_rect = false;
+        int best = std::numeric_limits<int>::max();
+};
+
+#endif // CONTRACTION_HIERARCHY_HPP
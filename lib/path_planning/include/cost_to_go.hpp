@@ -0,0 +1,94 @@
+#ifndef COST_TO_GO_HPP
+#define COST_TO_GO_HPP
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <memory>
+#include "grid_graph.hpp"
+#include "distance_field.hpp"
+
+// Cost from every cell to one goal, from a single Dijkstra run out of the goal
+// (moves cost the same both ways, so this is the reverse search). A start is
+// answered by descending the field: every cell but the goal has a neighbor
+// whose cost plus the move equals its own, so a path costs O(path length)
+// instead of a search.
+class CostToGoField {
+    public:
+        CostToGoField(const PlanningGraph& g, cell goal);
+
+        int get_cost(cell c) const {
+            if(c.first < 0 || c.first >= width || c.second < 0 || c.second >= height) return UNREACHED_DIST;
+            return dist[c];
+        }
+        bool reachable(cell c) const { return get_cost(c) != UNREACHED_DIST; }
+        // Shortest path from start to the goal; empty with an infinite distance when unreachable
+        pair<vector<cell>, float> descend(const PlanningGraph& g, cell start) const;
+
+        cell get_goal() const { return goal; }
+        uint64_t get_map_version() const { return map_version; }
+        size_t get_memory() const { return (size_t)dist.get_layout().size()*sizeof(int); }
+
+    private:
+        cell goal;
+        uint64_t map_version = 0;
+        int width = 0, height = 0;
+        CellArray<int> dist;
+};
+
+// Fields keyed by (map version, goal). Fields are evicted least recently used
+// first once their memory passes the budget; the newest field is always kept,
+// even alone over budget. Callers keep their fields alive after eviction
+// through the shared_ptr. Safe to share between threads.
+class CostToGoCache {
+    public:
+        CostToGoCache(size_t memory_budget = DEFAULT_MEMORY_BUDGET) : memory_budget(memory_budget) {}
+        // Field of goal on the current version of g, built on a miss
+        shared_ptr<const CostToGoField> get_field(const GridGraph& g, cell goal);
+        void clear();
+
+        size_t get_memory_used() const;
+        size_t get_memory_budget() const { return memory_budget; }
+        int get_num_fields() const;
+        int get_hits() const;
+        int get_misses() const;
+
+        // Cache used by planners that are not given one
+        static shared_ptr<CostToGoCache> get_shared_cache();
+
+        static const size_t DEFAULT_MEMORY_BUDGET = (size_t)256 << 20;
+
+    private:
+        typedef pair<uint64_t, cell> Key;
+        struct Entry {
+            Key key;
+            shared_ptr<const CostToGoField> field;
+        };
+
+        mutable std::mutex mutex;
+        std::list<Entry> entries;  // most recently used first
+        std::map<Key, std::list<Entry>::iterator> index;
+        size_t memory_budget, memory_used = 0;
+        int hits = 0, misses = 0;
+};
+
+// Planner interface over a cost-to-go cache: solve() fetches (or builds) the
+// field of the goal and descends it from the start
+class CostToGoSearch {
+    public:
+        CostToGoSearch(const GridGraph& g, shared_ptr<CostToGoCache> cache = CostToGoCache::get_shared_cache());
+        void solve(cell sp, cell ep, int timeout);
+        pair<vector<cell>, float> reconstruct_path(cell sp, cell ep);
+        // Only the path cells are visited
+        vector<cell> get_travelled_nodes();
+        shared_ptr<const CostToGoField> get_field() const { return field; }
+        bool goal_reached = false;
+
+    private:
+        const GridGraph* tree;
+        shared_ptr<CostToGoCache> cache;
+        shared_ptr<const CostToGoField> field;
+        pair<vector<cell>, float> result;
+};
+
+#endif // COST_TO_GO_HPP
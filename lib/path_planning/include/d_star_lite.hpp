@@ -0,0 +1,54 @@
+#ifndef D_STAR_LITE_HPP
+#define D_STAR_LITE_HPP
+
+#include "map_data.hpp"
+#include "grid_graph.hpp"
+#include "free_bitmap.hpp"
+#include "cell_layout.hpp"
+#include "indexed_heap.hpp"
+
+// D* Lite (Koenig & Likhachev) on the 8-connected grid. Costs to go are
+// searched backwards from the goal and kept between calls, so after the
+// map changes update_graph() only touches the edited cells and solve()
+// repairs the previous solution instead of planning from scratch. The
+// start may move between calls; a new goal starts a fresh search.
+class DStarLite {
+    public:
+        DStarLite(const PlanningGraph& g);
+        void solve(cell sp, cell ep, int timeout);
+        // Rebinds to the edited graph g. changed holds the regions whose cells
+        // may have been blocked or freed since the last call.
+        void update_graph(const PlanningGraph& g, const vector<CellRect>& changed);
+        pair<vector<cell>, float> reconstruct_path(cell sp, cell ep);
+        vector<cell> get_travelled_nodes();
+        uint64_t get_map_version() const { return map_version; }
+        bool goal_reached = false;
+
+    private:
+        struct Key {
+            int k1, k2;
+            bool operator<(const Key& o) const { return k1 < o.k1 || (k1 == o.k1 && k2 < o.k2); }
+        };
+        void reset(cell ep);
+        void bind(const PlanningGraph& g);
+        bool is_free(cell c) const;
+        Key get_key(cell_id id) const;
+        int get_min_successor(cell c) const;
+        void update_vertex(cell_id id);
+        void compute_shortest_path(int timeout);
+        const PlanningGraph* tree;
+        const FreeBitmap* free_cells;
+        CellLayout layout;
+        CellArray<int> g, rhs;
+        IndexedHeap<> open_set;
+        cell start, goal;
+        cell_id goal_id;
+        bool initialized = false;
+        int km = 0;  // heuristic offset added each time the start moves
+        uint64_t map_version = 0;
+        vector<cell_id> travelled;
+
+        static const int UNREACHED = std::numeric_limits<int>::max();
+};
+
+#endif // D_STAR_LITE_HPP
@@ -0,0 +1,14 @@
+#ifndef DIJKSTRA_HPP
+#define DIJKSTRA_HPP
+
+#include "best_first_search.hpp"
+
+// Dijkstra over the integer edge weights of a grid graph using a bucket
+// queue (Dial's algorithm)
+typedef BestFirstSearch<BucketOpenList, NoHeuristic, 8, int> Dijkstra;
+
+// A* on the same bucket queue with the Manhattan distance to the goal, which
+// never overestimates here since a diagonal move costs 2
+typedef BestFirstSearch<BucketOpenList, ManhattanHeuristic, 8, int> BucketAStar;
+
+#endif // DIJKSTRA_HPP
@@ -0,0 +1,16 @@
+#ifndef DISTANCE_FIELD_HPP
+#define DISTANCE_FIELD_HPP
+
+#include "map_data.hpp"
+#include "cell_layout.hpp"
+
+const int UNREACHED_DIST = std::numeric_limits<int>::max();
+
+// Lowers dist[c] to the cost from source to c wherever that is cheaper
+// (Dijkstra over a bucket queue). Cells that do not improve are not
+// expanded, so with dist starting at UNREACHED_DIST one call gives the
+// distance field of source and further calls give the distance to the
+// nearest of all sources.
+void update_distance_field(const PlanningGraph& g, cell source, CellArray<int>& dist);
+
+#endif // DISTANCE_FIELD_HPP
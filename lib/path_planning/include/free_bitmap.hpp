@@ -0,0 +1,73 @@
+#ifndef FREE_BITMAP_HPP
+#define FREE_BITMAP_HPP
+
+#include <vector>
+#include <cstdint>
+
+#include "map_data.hpp"
+
+// Packed 1-bit-per-cell free space bitmap derived from a Map. Each row keeps a
+// guard bit on both sides and the bitmap keeps a guard row above and below, so
+// neighbor lookups never need bounds checks.
+//
+// Neighbor masks use the MapData::DIR_* order: bit d is set when the neighbor
+// at (col+DIR_DX[d], row+DIR_DY[d]) is free.
+class FreeBitmap {
+    public:
+        FreeBitmap() {}
+        FreeBitmap(const Map& map);
+        FreeBitmap(int width, int height);
+        // Bitmap over padded words owned elsewhere (a mapped cache), which
+        // have to outlive it; copies of it own their words
+        static FreeBitmap view(int width, int height, uint64_t* words);
+        FreeBitmap(const FreeBitmap& other);
+        FreeBitmap(FreeBitmap&& other) noexcept;
+        FreeBitmap& operator=(FreeBitmap other) noexcept;
+
+        bool is_free(int col, int row) const {
+            if(col < 0 || col >= width || row < 0 || row >= height) return false;
+            int p = col+1;
+            return (row_words(row)[p >> 6] >> (p & 63)) & 1;
+        }
+
+        // 8-neighbor free mask of a single cell
+        uint8_t neighbor_mask(int col, int row) const {
+            int idx = window(row-1, col) | window(row, col) << 3 | window(row+1, col) << 6;
+            return MASK_LUT[idx];
+        }
+
+        void row_neighbor_masks(int row, uint8_t* out) const;
+        // Appends the runs of free cells of a row as (first, last) columns
+        void row_runs(int row, std::vector<std::pair<int, int>>& out) const;
+        void set_free(int col, int row, bool is_free);
+        int update(const Map& map, CellRect rect);
+        int count_free() const;
+        int get_width() const { return width; }
+        int get_height() const { return height; }
+        // Padded words, guard rows and bits included
+        const uint64_t* get_words() const { return words; }
+        size_t get_num_words() const { return (size_t)(height+2)*words_per_row; }
+
+    private:
+        // Padded rows start at -1 (guard row)
+        const uint64_t* row_words(int row) const { return words + (size_t)(row+1)*words_per_row; }
+        uint64_t* row_words(int row) { return words + (size_t)(row+1)*words_per_row; }
+
+        // Free bits of (col-1, col, col+1) in row as a 3-bit value
+        int window(int row, int col) const {
+            const uint64_t* w = row_words(row);
+            int i = col >> 6, s = col & 63;
+            uint64_t v = w[i] >> s;
+            if(s > 61) v |= w[i+1] << (64-s);
+            return v & 7;
+        }
+
+        static const uint8_t* build_mask_lut();
+        static const uint8_t* MASK_LUT;
+
+        int width = 0, height = 0, words_per_row = 0;
+        std::vector<uint64_t> bits;  // empty for a view
+        uint64_t* words = nullptr;   // bits.data() or the viewed words
+};
+
+#endif // FREE_BITMAP_HPP
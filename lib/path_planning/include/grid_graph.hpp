@@ -0,0 +1,33 @@
+#ifndef GRID_GRAPH_HPP
+#define GRID_GRAPH_HPP
+
+#include "map_data.hpp"
+#include "free_bitmap.hpp"
+
+// Implicit 8-connected graph over the open cells of a Map. Neighbors and
+// weights are generated on the fly from the packed free space bitmap so no
+// edge storage is allocated. update() patches the graph in place from the
+// regions of the map edited since it was built.
+class GridGraph : public PlanningGraph {
+    public:
+        GridGraph() {}
+        GridGraph(const Map& map);
+        GridGraph(FreeBitmap free_cells, uint64_t map_version);
+        bool update(const Map& map);
+        bool is_node_valid(cell node) const override;
+        NeighborList get_neighbors(cell parent) const override;
+        vector<cell> get_nodes() const override;
+        int get_size() const override;
+        int get_width() const override { return free_cells.get_width(); }
+        int get_height() const override { return free_cells.get_height(); }
+        uint8_t get_neighbor_mask(cell node) const;
+        const FreeBitmap& get_free_bitmap() const { return free_cells; }
+        uint64_t get_map_version() const { return map_version; }
+
+    private:
+        FreeBitmap free_cells;
+        int num_nodes = 0;
+        uint64_t map_version = 0;
+};
+
+#endif // GRID_GRAPH_HPP
@@ -0,0 +1,81 @@
+#ifndef HPA_STAR_HPP
+#define HPA_STAR_HPP
+
+#include "map_data.hpp"
+#include "grid_graph.hpp"
+#include "free_bitmap.hpp"
+#include "bucket_queue.hpp"
+
+// HPA* (Botea et al.) on the 8-connected grid. The map is split into square
+// clusters; entrances are placed on the free runs along each cluster border
+// (the middle of short runs, both ends of long ones) plus the diagonal moves
+// that only cross at a single cell, and the distances between the entrances
+// of a cluster are computed inside it, one cluster per worker thread. A
+// query connects start and goal to the entrances of their clusters, runs A*
+// over the entrances and refines each step with a search inside a single
+// cluster. Paths are near optimal. After the map changes update_graph() only
+// rebuilds the clusters within one cell of the edited regions.
+class HPAStar {
+    public:
+        HPAStar(const PlanningGraph& g, int cluster_size = DEFAULT_CLUSTER_SIZE);
+        void solve(cell sp, cell ep, int timeout);
+        // Rebinds to the edited graph g. changed holds the regions whose cells
+        // may have been blocked or freed; returns the number of clusters rebuilt.
+        int update_graph(const PlanningGraph& g, const vector<CellRect>& changed);
+        pair<vector<cell>, float> reconstruct_path(cell sp, cell ep);
+        vector<cell> get_travelled_nodes();
+        uint64_t get_map_version() const { return map_version; }
+        int get_num_clusters() const { return clusters.size(); }
+        int get_num_entrances() const { return node_cluster.size(); }
+        bool goal_reached = false;
+
+        static const int DEFAULT_CLUSTER_SIZE = 16;
+        // Free runs at least this long get an entrance at both ends
+        static const int LONG_ENTRANCE = 6;
+
+    private:
+        struct Transition {
+            cell from;     // entrance of this cluster
+            cell to;       // entrance of the neighboring cluster
+            int weight;
+        };
+        struct Cluster {
+            CellRect rect;
+            vector<cell> nodes;              // entrances, sorted
+            vector<int> dist;                // nodes x nodes, UNREACHED if not connected inside
+            vector<Transition> transitions;
+            vector<vector<pair<int, int>>> links;  // (global entrance, weight) of each entrance
+            int first_node = 0;              // global id of nodes[0]
+        };
+        // Dijkstra restricted to one cluster (cell ids are local to the rect)
+        struct LocalSearch {
+            vector<int> dist, parent;
+            BucketQueue queue = BucketQueue(MapData::DIR_WEIGHT[MAX_NEIGHBORS-1]);
+        };
+
+        void bind(const PlanningGraph& g);
+        bool is_free(cell c) const;
+        int get_cluster(cell c) const;
+        void border_transitions(int a, int b, vector<Transition>& out) const;
+        void build_cluster(Cluster& c, int id, LocalSearch& search) const;
+        void build_clusters(const vector<int>& ids);
+        void link_clusters();
+        void local_search(const CellRect& rect, cell source, LocalSearch& search, cell target = {-1, -1}) const;
+
+        const PlanningGraph* tree;
+        const FreeBitmap* free_cells;
+        uint64_t map_version = 0;
+        int width, height, cluster_size, clusters_x, clusters_y;
+        vector<Cluster> clusters;
+        vector<int> node_cluster;            // cluster of each global entrance
+
+        // Last query: abstract search over the entrances plus start and goal
+        cell start, goal;
+        vector<int> abstract_dist, abstract_parent;
+        vector<cell> travelled;
+        LocalSearch search;
+
+        static constexpr int UNREACHED = std::numeric_limits<int>::max();
+};
+
+#endif // HPA_STAR_HPP
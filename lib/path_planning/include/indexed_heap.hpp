@@ -0,0 +1,128 @@
+#ifndef INDEXED_HEAP_HPP
+#define INDEXED_HEAP_HPP
+
+#include <vector>
+#include <cstdint>
+
+#include "cell_layout.hpp"
+
+// D-ary min-heap of cell ids with decrease-key. The heap position of every
+// cell is kept in a CellArray, so membership checks are O(1) and push, pop
+// and decrease-key are O(log n) without allocating once the heap has grown.
+// Equal keys pop the entry with the larger tie value first (A* passes g so
+// deeper nodes win ties).
+template<int D = 4>
+class IndexedHeap {
+    public:
+        IndexedHeap() {}
+        IndexedHeap(int width, int height) : pos(width, height, NOT_IN_HEAP) {}
+
+        bool empty() const { return items.empty(); }
+        size_t size() const { return items.size(); }
+        bool contains(cell_id id) const { return pos[id] != NOT_IN_HEAP; }
+        cell_id top() const { return items[0].id; }
+        float top_key() const { return items[0].key; }
+        float top_tie() const { return items[0].tie; }
+
+        // Inserts id or moves it up if it is already queued
+        void push(cell_id id, float key, float tie = 0){
+            int i = pos[id];
+            if(i == NOT_IN_HEAP){
+                i = items.size();
+                items.push_back(Item{key, tie, id});
+                pos[id] = i;
+            }
+            else{
+                items[i].key = key;
+                items[i].tie = tie;
+            }
+            sift_up(i);
+        }
+
+        cell_id pop(){
+            cell_id id = items[0].id;
+            pos[id] = NOT_IN_HEAP;
+            Item last = items.back();
+            items.pop_back();
+            if(!items.empty()){
+                items[0] = last;
+                pos[last.id] = 0;
+                sift_down(0);
+            }
+            return id;
+        }
+
+        // Takes id out of the heap if it is queued
+        void remove(cell_id id){
+            int i = pos[id];
+            if(i == NOT_IN_HEAP) return;
+            pos[id] = NOT_IN_HEAP;
+            Item last = items.back();
+            items.pop_back();
+            if(i == (int)items.size()) return;
+            items[i] = last;
+            pos[last.id] = i;
+            sift_up(i);
+            sift_down(pos[last.id]);
+        }
+
+        // Calls visit(id, key) on every queued cell, in no particular order
+        template<typename Visit>
+        void for_each(Visit visit) const {
+            for(auto& item: items) visit(item.id, item.key);
+        }
+
+        void clear(){
+            for(auto& item: items) pos[item.id] = NOT_IN_HEAP;
+            items.clear();
+        }
+
+    private:
+        struct Item {
+            float key, tie;
+            cell_id id;
+        };
+
+        static bool before(const Item& a, const Item& b){
+            return a.key < b.key || (a.key == b.key && a.tie > b.tie);
+        }
+
+        void sift_up(int i){
+            Item item = items[i];
+            while(i > 0){
+                int p = (i-1)/D;
+                if(!before(item, items[p])) break;
+                items[i] = items[p];
+                pos[items[i].id] = i;
+                i = p;
+            }
+            items[i] = item;
+            pos[item.id] = i;
+        }
+
+        void sift_down(int i){
+            Item item = items[i];
+            int n = items.size();
+            while(true){
+                int first = i*D + 1;
+                if(first >= n) break;
+                int best = first;
+                int last = std::min(first+D, n);
+                for(int c = first+1; c < last; c++){
+                    if(before(items[c], items[best])) best = c;
+                }
+                if(!before(items[best], item)) break;
+                items[i] = items[best];
+                pos[items[i].id] = i;
+                i = best;
+            }
+            items[i] = item;
+            pos[item.id] = i;
+        }
+
+        static const int32_t NOT_IN_HEAP = -1;
+        std::vector<Item> items;
+        CellArray<int32_t> pos;
+};
+
+#endif // INDEXED_HEAP_HPP
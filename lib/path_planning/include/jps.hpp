@@ -0,0 +1,63 @@
+#ifndef JPS_HPP
+#define JPS_HPP
+
+#include <memory>
+#include "map_data.hpp"
+#include "grid_graph.hpp"
+#include "free_bitmap.hpp"
+#include "cell_layout.hpp"
+#include "indexed_heap.hpp"
+
+// Jump distances of every cell in the 8 MapData::DIR_* directions (JPS+).
+// A positive value is the number of steps to the next jump point in that
+// direction, zero or a negative value is minus the number of free steps
+// before the next blocked cell. Distances are 16-bit; a run longer than
+// MAX_JUMP gets an extra jump point, which keeps the search exact.
+class JumpTable {
+    public:
+        JumpTable(const FreeBitmap& free_cells);
+        int get(int col, int row, int d) const { return dists[((size_t)row*width + col)*MAX_NEIGHBORS + d]; }
+        int get_width() const { return width; }
+        int get_height() const { return height; }
+
+        static const int MAX_JUMP = std::numeric_limits<int16_t>::max();
+
+    private:
+        int16_t& at(int col, int row, int d) { return dists[((size_t)row*width + col)*MAX_NEIGHBORS + d]; }
+        int width, height;
+        vector<int16_t> dists;
+};
+
+// Jump point search (JPS+) on the 8-connected grid. Only jump points enter
+// the open list and their successors are looked up in a JumpTable, so
+// straight and diagonal runs through open space cost a single expansion.
+// Paths have the same cost as A*.
+class JPS {
+    public:
+        JPS(const PlanningGraph& g);
+        void solve(cell sp, cell ep, int timeout);
+        pair<vector<cell>, float> reconstruct_path(cell sp, cell ep);
+        vector<cell> get_travelled_nodes();
+        static shared_ptr<const JumpTable> get_jump_table(const GridGraph& g);
+        bool goal_reached = false;
+
+    private:
+        enum NodeState : uint8_t { UNSEEN, OPEN, CLOSED };
+        bool is_free(int col, int row) const { return free_cells->is_free(col, row); }
+        unsigned get_directions(cell c) const;
+        void add_successor(cell_id curr, cell next, int cost, cell ep);
+        const PlanningGraph& tree;
+        FreeBitmap own_cells;  // free cells of graphs that are not a GridGraph
+        const FreeBitmap* free_cells;
+        shared_ptr<const JumpTable> jumps;
+        CellLayout layout;
+        CellArray<int> dist;
+        CellArray<cell_id> parent;
+        CellArray<uint8_t> state;
+        IndexedHeap<> open_set;
+        vector<cell_id> travelled;
+
+        static const int UNREACHED = std::numeric_limits<int>::max();
+};
+
+#endif // JPS_HPP
@@ -0,0 +1,68 @@
+#ifndef LANDMARKS_HPP
+#define LANDMARKS_HPP
+
+#include <memory>
+#include <algorithm>
+#include "best_first_search.hpp"
+
+// Exact distances from K landmark cells to every cell (ALT preprocessing).
+// By the triangle inequality |d(L,b) - d(L,a)| never overestimates the cost
+// from a to b. Landmarks are picked by farthest-point selection, each one as
+// far as possible from the ones before, and their Dijkstra fields are
+// computed in parallel. Distances are stored row-major as 16-bit values per
+// cell (all K landmarks side by side); larger distances saturate, which
+// keeps the bound admissible.
+class LandmarkTable {
+    public:
+        LandmarkTable(const PlanningGraph& g, int num_landmarks);
+        // Table stored by serialize(); nullptr if the data does not fit g
+        static shared_ptr<LandmarkTable> deserialize(const void* data, size_t size, const PlanningGraph& g);
+        vector<char> serialize() const;
+
+        int lower_bound(cell a, cell b) const {
+            const uint16_t* da = &dists[((size_t)a.second*width + a.first)*num_landmarks];
+            const uint16_t* db = &dists[((size_t)b.second*width + b.first)*num_landmarks];
+            int best = 0;
+            for(int i = 0; i < num_landmarks; i++){
+                if(da[i] == UNREACHED || db[i] == UNREACHED) continue;
+                best = std::max(best, std::abs((int)da[i] - (int)db[i]));
+            }
+            return best;
+        }
+        const vector<cell>& get_landmarks() const { return landmarks; }
+        bool matches(const FreeBitmap& free_cells) const {
+            return free_cells.get_num_words() == words.size() && std::equal(words.begin(), words.end(), free_cells.get_words());
+        }
+
+        // Table of the last GridGraph asked for; rebuilt when its map version,
+        // its free cells or the landmark count change
+        static shared_ptr<const LandmarkTable> get_landmark_table(const GridGraph& g, int num_landmarks = DEFAULT_LANDMARKS);
+
+        static constexpr int DEFAULT_LANDMARKS = 8;
+        static constexpr uint16_t UNREACHED = 0xFFFF;
+
+    private:
+        LandmarkTable() {}
+        int width = 0, height = 0, num_landmarks = 0;
+        vector<cell> landmarks;
+        vector<uint16_t> dists;
+        vector<uint64_t> words;  // free cells of the GridGraph the table was built from
+};
+
+// Octile distance raised to the landmark bound (both are consistent, so the
+// max is too). Without a table it is the octile distance.
+struct LandmarkHeuristic {
+    static const bool IS_ZERO = false;
+    LandmarkHeuristic() {}
+    LandmarkHeuristic(shared_ptr<const LandmarkTable> table) : table(table) {}
+    template<typename W> W cost(cell a, cell b) const {
+        W h = OctileHeuristic::cost<W>(a, b);
+        return table ? std::max(h, (W)table->lower_bound(a, b)) : h;
+    }
+    shared_ptr<const LandmarkTable> table;
+};
+
+// A* with landmark (ALT) heuristics: ALTAStar(g, LandmarkHeuristic(table))
+typedef BestFirstSearch<HeapOpenList<4>, LandmarkHeuristic, 8, int> ALTAStar;
+
+#endif // LANDMARKS_HPP
@@ -0,0 +1,45 @@
+#ifndef LAYERED_MAP_HPP
+#define LAYERED_MAP_HPP
+
+#include <vector>
+#include <cstdint>
+
+#include "map_data.hpp"
+
+struct OverlayCell {
+    int col, row;
+    int8_t val;
+};
+
+// Map drawn as a base map plus sparse overlay layers (paths, travelled
+// nodes, start and goal points). The base is referenced, never copied or
+// modified, and has to outlive the layered map. The base grid already holds
+// obstacles and their inflation (INFLATE_INT), which is what the planners
+// see. Overlays only store the cells they cover and are composed at render
+// time: later cells are drawn over earlier ones, later layers over earlier
+// layers and all of them over the base.
+class LayeredMap {
+    public:
+        LayeredMap() {}
+        LayeredMap(const Map& base) : base(&base) {}
+        void set_base(const Map& map) { base = &map; }
+        const Map& get_base() const { return *base; }
+        int get_width() const { return base->px_width; }
+        int get_height() const { return base->px_height; }
+
+        int add_layer();
+        void clear_layer(int layer);
+        void add_cells(int layer, const vector<cell>& cells, int8_t val);
+        void add_point(int layer, cell pt, int8_t val, int size);
+        void add_path(int layer, const vector<cell>& path, int8_t val, int size);
+        const vector<vector<OverlayCell>>& get_layers() const { return layers; }
+
+        int8_t value_at(int col, int row) const;
+        Map compose() const;
+
+    private:
+        const Map* base = nullptr;
+        vector<vector<OverlayCell>> layers;
+};
+
+#endif // LAYERED_MAP_HPP
@@ -0,0 +1,98 @@
+#ifndef MAP_CACHE_HPP
+#define MAP_CACHE_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <map>
+
+#include "map_data.hpp"
+#include "free_bitmap.hpp"
+#include "grid_graph.hpp"
+#include "landmarks.hpp"
+#include "contraction_hierarchy.hpp"
+#include "components.hpp"
+
+// Precomputed map data stored next to the map yaml as
+// <name>_inflate<N>.rppc. The file is a header, a section table and 64-byte
+// aligned sections. It is memory mapped on load, so sections are used in
+// place without parsing. A cache only matches the yaml and PGM it was built
+// from and the inflate size it was built with. The PGM is matched by size and
+// modification time, and only hashed when those changed.
+enum CacheSectionType : uint32_t {
+    CACHE_GRID = 1,           // inflated occupancy grid, int8 row-major
+    CACHE_FREE_BITMAP = 2,    // FreeBitmap words (adjacency of the GridGraph)
+    CACHE_COMPONENTS = 3,     // ComponentLabels::serialize()
+    CACHE_DISTANCE_FIELD = 4, // reserved for distance fields
+    CACHE_LANDMARKS = 5,      // LandmarkTable::serialize()
+    CACHE_CONTRACTION_HIERARCHY = 6  // ContractionHierarchy::serialize()
+};
+
+struct CacheHeader {
+    char magic[8];
+    uint32_t format_version;
+    int32_t inflate_size;
+    uint64_t pgm_hash, pgm_size;
+    int64_t pgm_mtime;  // nanoseconds since the epoch
+    uint64_t yaml_hash;
+    int32_t width, height;
+    float resolution, m_width, m_height;
+    uint32_t num_sections;
+};
+
+struct CacheSectionEntry {
+    uint32_t type, reserved;
+    uint64_t offset, size;
+};
+
+// Section data to be written to a cache
+struct CacheBlob {
+    uint32_t type;
+    const void* data;
+    size_t size;
+};
+
+class MapCache {
+    public:
+        MapCache() {}
+        ~MapCache();
+        MapCache(const MapCache&) = delete;
+        MapCache& operator=(const MapCache&) = delete;
+
+        static string get_cache_path(string yaml_path, int inflate_size);
+        static uint64_t hash_file(string path);
+        // Size and modification time of a file, false if it can not be read
+        static bool stat_file(string path, uint64_t* size, int64_t* mtime);
+        static bool write(string yaml_path, int inflate_size, const Map& map, const vector<CacheBlob>& extra = {});
+
+        bool open(string yaml_path, int inflate_size);
+        void close();
+        bool is_open() const { return header != nullptr; }
+        const void* get_section(uint32_t type, size_t* size = nullptr) const;
+
+        // Inflated map of the yaml, read from the cache or built and cached
+        Map load_map(string yaml_path, int inflate_size);
+        GridGraph get_graph(const Map& map) const;
+        // Landmark table of the map, read from the cache or built and added
+        // to it (maps edited since load_map are never written back)
+        shared_ptr<const LandmarkTable> get_landmarks(const Map& map, const GridGraph& g, int num_landmarks);
+        // Same for the contraction hierarchy of the map
+        shared_ptr<const ContractionHierarchy> get_contraction_hierarchy(const Map& map, const GridGraph& g);
+        // And for the connected component labels
+        shared_ptr<const ComponentLabels> get_components(const Map& map, const GridGraph& g);
+
+        static const uint32_t FORMAT_VERSION = 2;
+
+    private:
+        void add_section(const Map& map, uint32_t type, vector<char> section);
+
+        void* data = nullptr;
+        size_t length = 0;
+        const CacheHeader* header = nullptr;
+        uint64_t map_version = 0;  // version of the map last returned by load_map
+        string yaml_path;
+        int inflate_size = 0;
+        std::map<uint32_t, vector<char>> added;  // sections written since open
+};
+
+#endif // MAP_CACHE_HPP
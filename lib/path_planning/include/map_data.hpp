@@ -7,95 +7,191 @@
 #include <sstream>
 #include <map>
 #include <vector>
+#include <memory>
 #include <filesystem>
+#include <cstdint>
 
 #include <opencv2/opencv.hpp>
 #include <opencv2/highgui.hpp>
 
+#include "occupancy_grid.hpp"
+
 using namespace std;
 using namespace cv;
 
 typedef pair<int,int> cell;     // coordingate from map (x,y) := (col,row)
 typedef pair<cell,int> iw_cell; // cell with integer weight
 
+// Cells [col, col+width) x [row, row+height) of a map
+struct CellRect{
+    int col, row, width, height;
+};
+
+// Region touched by an edit that moved a map from prev_version to version
+struct MapEdit{
+    uint64_t prev_version, version;
+    CellRect rect;
+};
+
 struct Map{
+    Map();  // every map starts with a version of its own
     int px_width, px_height;
     float resolution, m_width, m_height; // in meters
-    int** boundaries;
+    OccupancyGrid boundaries;
+    uint64_t version;        // unique per map, changes on every edit (see MapData::mark_dirty)
+    vector<MapEdit> edits;   // most recent edits, oldest first
 };
 
-// Change this class to use unordered_map (requires default constructor)
-class Graph {
-    public:    
-        map<cell, vector<iw_cell>> g;
+class LayeredMap;
+class FreeBitmap;
+
+// Max number of neighbors of a node on an 8-connected grid
+const int MAX_NEIGHBORS = 8;
+
+// Expansions between timeout checks of a search; reading the clock every
+// expansion costs more than the expansion
+const int TIMEOUT_CHECK_INTERVAL = 1024;
+
+// Fixed-capacity list of weighted neighbors (no heap allocation)
+struct NeighborList {
+    iw_cell data[MAX_NEIGHBORS];
+    int count = 0;
+
+    void push_back(iw_cell c){ data[count++] = c; }
+    const iw_cell* begin() const { return data; }
+    const iw_cell* end() const { return data+count; }
+    int size() const { return count; }
+};
+
+// Common interface for graphs that planners search over, either an explicit
+// Graph or an implicit view over the occupancy grid (GridGraph)
+class PlanningGraph {
+    public:
         cell root = {0, 0};
         cell end = {0, 0};
 
-        vector<pair<cell, int>> get_edges(cell parent){
-            try{
-                return g[parent];
-            }
-            catch(const std::out_of_range& oor){
-                return vector<iw_cell>();
-            }
-        }
+        virtual ~PlanningGraph() {}
+        virtual bool is_node_valid(cell node) const = 0;
+        virtual NeighborList get_neighbors(cell parent) const = 0;
+        virtual vector<cell> get_nodes() const = 0;
+        virtual int get_size() const = 0;
+        virtual int get_width() const = 0;
+        virtual int get_height() const = 0;
+};
 
-        vector<cell> get_edges_without_weights(cell parent){
-            try{
-                vector<cell> temp; 
-                for(auto child: g[parent]){
-                    temp.push_back(child.first);
-                }
-                return temp;
-            }
-            catch(const std::out_of_range& oor){
-                return vector<cell>();
-            }
-        }
+// Read-only graph shared by planners and worker threads. Copying a snapshot
+// only bumps a reference count; the graph stays alive while any copy exists.
+typedef shared_ptr<const PlanningGraph> GraphSnapshot;
 
-        bool is_node_valid(cell node){
-            //if(g[node].size() > 0) return true;
-            if(g.find(node) != g.end()) return true;
-            else return false;
-        }
+// Read-only view over the contiguous out-edges of a single node in a Graph
+class EdgeSpan {
+    public:
+        class iterator {
+            public:
+                iterator(const int* t, const uint8_t* w, int width) : target(t), weight(w), width(width) {}
+                iw_cell operator*() const { return {cell{*target % width, *target / width}, *weight}; }
+                iterator& operator++(){ target++; weight++; return *this; }
+                bool operator!=(const iterator& other) const { return target != other.target; }
+                bool operator==(const iterator& other) const { return target == other.target; }
+            private:
+                const int* target;
+                const uint8_t* weight;
+                int width;
+        };
+
+        EdgeSpan() : targets(nullptr), weights(nullptr), count(0), width(1) {}
+        EdgeSpan(const int* t, const uint8_t* w, int n, int width) : targets(t), weights(w), count(n), width(width) {}
+        iterator begin() const { return iterator(targets, weights, width); }
+        iterator end() const { return iterator(targets+count, weights+count, width); }
+        iw_cell operator[](int i) const { return {cell{targets[i] % width, targets[i] / width}, weights[i]}; }
+        int size() const { return count; }
+        bool empty() const { return count == 0; }
+
+    private:
+        const int* targets;
+        const uint8_t* weights;
+        int count, width;
+};
 
-        vector<cell> get_nodes(){
-            vector<cell> nodes;
-            for(auto node: g) nodes.push_back(node.first);
-            return nodes;
+// Compressed sparse row (CSR) graph indexed by linear cell id (row*width + col).
+// Edges of node id are stored in [offsets[id], offsets[id+1]) of the flat edge
+// arrays, so nodes have to be added in increasing id (row-major) order.
+class Graph : public PlanningGraph {
+    public:
+        Graph() {}
+        Graph(int width, int height);
+
+        EdgeSpan get_edges(cell parent) const {
+            if(!in_bounds(parent)) return EdgeSpan();
+            int id = to_id(parent);
+            if(id > last_id) return EdgeSpan();
+            int first = offsets[id];
+            int last = id < last_id ? offsets[id+1] : (int)targets.size();
+            return EdgeSpan(targets.data()+first, weights.data()+first, last-first, width);
         }
 
-        void add_node(cell node){
-            g[node] = vector<iw_cell>();
+        bool is_node_valid(cell node) const override {
+            return in_bounds(node) && nodes[to_id(node)];
         }
 
-        void add_edge(cell parent, cell child, int weight){
-            g[parent].push_back({child, weight});
+        NeighborList get_neighbors(cell parent) const override {
+            NeighborList neighbors;
+            for(auto edge: get_edges(parent)) neighbors.push_back(edge);
+            return neighbors;
         }
 
-        int get_size(){
-            return g.size();
+        vector<cell> get_edges_without_weights(cell parent) const;
+        vector<cell> get_nodes() const override;
+        void add_node(cell node);
+        void add_edge(cell parent, cell child, int weight);
+        void reserve_edges(size_t num_edges);
+        int get_size() const override { return num_nodes; }
+        int get_width() const override { return width; }
+        int get_height() const override { return height; }
+
+    private:
+        bool in_bounds(cell c) const {
+            return c.first >= 0 && c.first < width && c.second >= 0 && c.second < height;
         }
+        int to_id(cell c) const { return c.second*width + c.first; }
+        void open_node(int id);
+
+        int width = 0, height = 0;
+        int num_nodes = 0;
+        int last_id = -1;           // last node with an open edge range
+        vector<int> offsets;        // first edge index of each node
+        vector<int> targets;        // linear id of edge target
+        vector<uint8_t> weights;    // edge weight
+        vector<bool> nodes;         // node exists in graph
 };
 
 class MapData {
     public:
         static Map get_map(string yp);
-        static int** copy_boundaries(Map m);
-        static Map copy_map(Map map);
-        static int** inflate_boundaries(Map map, int buffer_size);
-        static int** remove_boundary_inflation(Map map);
-        static void inflate_point(Map map, cell pt, int inflate_size);
-        static Map add_path_to_map(Map m, vector<cell> path, cell sp, cell ep);
-        static Map add_path_to_map_with_value(Map map, int pixel_val, vector<cell> path, cell sp, cell ep);
-        static Map debug_map(Map m, vector<cell> path, vector<cell> travelled, cell sp, cell ep);
-        static Graph get_graph_from_map(Map map);
-        static void print_boundary(int** b, int width, int height);
-        static void show_map(string title, Map map);
+        static string get_image_path(string yp);
+        static OccupancyGrid copy_boundaries(const Map& map);
+        static Map copy_map(const Map& map);
+        static OccupancyGrid inflate_boundaries(const Map& map, int buffer_size);
+        static OccupancyGrid remove_boundary_inflation(const Map& map);
+        static void inflate_point(Map& map, cell pt, int inflate_size);
+        static CellRect point_rect(const Map& map, cell pt, int inflate_size);
+        static uint64_t new_version();
+        static void mark_dirty(Map& map, CellRect rect);
+        static bool get_dirty_rects(const Map& map, uint64_t since_version, vector<CellRect>& rects);
+        static void copy_region(const Map& src, Map& dst, CellRect rect);
+        static Map add_path_to_map(const Map& m, vector<cell> path, cell sp, cell ep);
+        static Map add_path_to_map_with_value(const Map& map, int pixel_val, vector<cell> path, cell sp, cell ep);
+        static Map debug_map(const Map& m, vector<cell> path, vector<cell> travelled, cell sp, cell ep);
+        static Graph get_graph_from_map(const Map& map);
+        static vector<FreeBitmap> get_occupancy_pyramid(const FreeBitmap& base, int min_size = PYRAMID_MIN_SIZE);
+        static FreeBitmap downsample_occupancy(const FreeBitmap& fine);
+        static void print_boundary(const OccupancyGrid& b, int width, int height);
+        static void show_map(string title, const Map& map);
+        static void show_map(string title, const LayeredMap& map);
 
         // Map-Robot Conversions
-        static cell POSE2PIXEL(Map map, float x, float y);
-        static pair<float, float> PIXEL2POSE(Map map, cell px);
+        static cell POSE2PIXEL(const Map& map, float x, float y);
+        static pair<float, float> PIXEL2POSE(const Map& map, cell px);
 
         // Map Variables
         static const int INFLATE_INT = -2;
@@ -109,9 +205,21 @@ class MapData {
         static const int PATH_SIZE = 3;
         static const int POINT_SIZE = 5;
 
+        // Number of edits a map remembers for incremental updates
+        static const int MAX_MAP_EDITS = 256;
+
+        // Pyramids stop halving once the map is at most this many cells across
+        static const int PYRAMID_MIN_SIZE = 32;
+
+        // 8-connected neighbor offsets and weights (Up, Down, Left, Right,
+        // Up-Left, Up-Right, Down-Left, Down-Right)
+        static constexpr int DIR_DX[MAX_NEIGHBORS] = { 0, 0, -1, 1, -1,  1, -1, 1};
+        static constexpr int DIR_DY[MAX_NEIGHBORS] = {-1, 1,  0, 0, -1, -1,  1, 1};
+        static constexpr int DIR_WEIGHT[MAX_NEIGHBORS] = {1, 1, 1, 1, 2, 2, 2, 2};
+
     private:
         static Map parse_pgm(string fp);
-        static void inflate_pixel(int** nb, int width, int height, int j, int i, int buffer_size);
+        static void inflate_pixel(OccupancyGrid& nb, int width, int height, int j, int i, int buffer_size);
 };
 
 #endif // MAP_DATA_HPP
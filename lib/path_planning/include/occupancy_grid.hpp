@@ -0,0 +1,56 @@
+#ifndef OCCUPANCY_GRID_HPP
+#define OCCUPANCY_GRID_HPP
+
+#include <memory>
+#include <cstdint>
+#include <stdexcept>
+
+#include <opencv2/opencv.hpp>
+
+// Non-owning view over a rectangular region of an occupancy grid
+class GridView {
+    public:
+        GridView(int8_t* data, int width, int height, int stride)
+            : cells(data), width(width), height(height), stride(stride) {}
+        int8_t* operator[](int row) const { return cells + (size_t)row*stride; }
+        void fill(int8_t val);
+        int get_width() const { return width; }
+        int get_height() const { return height; }
+
+    private:
+        int8_t* cells;
+        int width, height, stride;
+};
+
+// Contiguous row-major grid of int8 cells. Owns its buffer unless it was
+// created over an existing cv::Mat or raw buffer, in which case the buffer
+// has to outlive the grid. Move-only, use clone() for a deep copy.
+class OccupancyGrid {
+    public:
+        OccupancyGrid() {}
+        OccupancyGrid(int width, int height, int8_t fill_val = 0);
+        OccupancyGrid(int8_t* data, int width, int height, int stride = 0);
+        static OccupancyGrid wrap(cv::Mat& mat);
+
+        OccupancyGrid(const OccupancyGrid&) = delete;
+        OccupancyGrid& operator=(const OccupancyGrid&) = delete;
+        OccupancyGrid(OccupancyGrid&& other) noexcept;
+        OccupancyGrid& operator=(OccupancyGrid&& other) noexcept;
+
+        int8_t* operator[](int row) { return cells + (size_t)row*stride; }
+        const int8_t* operator[](int row) const { return cells + (size_t)row*stride; }
+        OccupancyGrid clone() const;
+        GridView view(int col, int row, int view_width, int view_height);
+        int get_width() const { return width; }
+        int get_height() const { return height; }
+        int get_stride() const { return stride; }
+        bool owns_data() const { return owned != nullptr; }
+        bool empty() const { return cells == nullptr; }
+
+    private:
+        std::unique_ptr<int8_t[]> owned;
+        int8_t* cells = nullptr;
+        int width = 0, height = 0, stride = 0;
+};
+
+#endif // OCCUPANCY_GRID_HPP
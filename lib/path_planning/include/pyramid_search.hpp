@@ -0,0 +1,97 @@
+#ifndef PYRAMID_SEARCH_HPP
+#define PYRAMID_SEARCH_HPP
+
+#include <chrono>
+#include <memory>
+
+#include "map_data.hpp"
+#include "free_bitmap.hpp"
+#include "grid_graph.hpp"
+#include "bucket_queue.hpp"
+
+// Coarse-to-fine planning over the conservative occupancy pyramid of
+// MapData::get_occupancy_pyramid(). A* first runs on the coarsest level; each
+// finer level is then searched only inside a corridor around the children of
+// the coarser path. A coarse free cell has all of its children free, so the
+// corridor almost always holds a path; when it does not (start or goal sit in
+// a blocked coarse cell) the corridor is widened, and a level with no path at
+// all makes the search start over from the next finer one. Only cells near the
+// path are visited, so large maps cost roughly the path length rather than the
+// map area. Paths are usually close to optimal, with no bound.
+//
+// The pyramid of a GridGraph is shared between searches (see get_pyramid) and
+// search state is allocated per tile on first touch, so a new PyramidSearch
+// per query does not cost the map area either.
+class PyramidSearch {
+    public:
+        typedef vector<FreeBitmap> Pyramid;
+
+        PyramidSearch(const PlanningGraph& g, int min_size = MapData::PYRAMID_MIN_SIZE);
+        void solve(cell sp, cell ep, int timeout);
+        pair<vector<cell>, float> reconstruct_path(cell sp, cell ep);
+        // Cells expanded at full resolution
+        vector<cell> get_travelled_nodes();
+        int get_num_levels() const { return levels->size(); }
+        // Level the last path was first found at and how often its corridors were widened
+        int get_start_level() const { return start_level; }
+        int get_widenings() const { return widenings; }
+        bool goal_reached = false;
+
+        // Pyramid of the last GridGraph asked for, rebuilt when its map
+        // version, size or min_size changes
+        static shared_ptr<const Pyramid> get_pyramid(const GridGraph& g, int min_size = MapData::PYRAMID_MIN_SIZE);
+
+        // Corridor half-width, in cells of the coarser level, of the first attempt
+        static const int CORRIDOR_RADIUS = 1;
+        // Side of the square tiles search state is allocated in (a power of 2)
+        static const int TILE_SHIFT = 6;
+
+    private:
+        static const int TILE_MASK = (1 << TILE_SHIFT) - 1;
+
+        // Entries are reset by stamps: dist and parent_dir only hold for the
+        // search whose id is in visited
+        struct CellState {
+            int dist;
+            uint32_t visited, corridor;
+            int8_t parent_dir;
+        };
+
+        // Search state of one level, allocated a zeroed tile at a time
+        struct LevelState {
+            int width = 0, tiles_wide = 0;
+            vector<std::unique_ptr<CellState[]>> tiles;
+
+            void init(int width, int height);
+            CellState& at(cell c){
+                auto& tile = tiles[(c.second >> TILE_SHIFT)*tiles_wide + (c.first >> TILE_SHIFT)];
+                if(!tile) tile.reset(new CellState[1 << 2*TILE_SHIFT]());
+                return tile[(c.second & TILE_MASK) << TILE_SHIFT | (c.first & TILE_MASK)];
+            }
+            // Null when the tile of c was never touched
+            const CellState* find(cell c) const {
+                auto& tile = tiles[(c.second >> TILE_SHIFT)*tiles_wide + (c.first >> TILE_SHIFT)];
+                return tile ? &tile[(c.second & TILE_MASK) << TILE_SHIFT | (c.first & TILE_MASK)] : nullptr;
+            }
+        };
+
+        bool search(int level, bool in_corridor, vector<cell>& path);
+        bool mark_corridor(int level, const vector<cell>& coarse_path, int radius);
+        bool timed_out();
+
+        const PlanningGraph* tree;
+        shared_ptr<const Pyramid> levels;
+        vector<LevelState> states;
+        uint32_t search_id = 0, corridor_id = 0;
+        BucketQueue queue = BucketQueue(2*MapData::DIR_WEIGHT[MAX_NEIGHBORS-1]);
+
+        // Last query
+        cell start, goal;
+        vector<cell> path;
+        float dist = 0;
+        int start_level = -1, widenings = 0;
+        vector<cell> travelled;
+        std::chrono::high_resolution_clock::time_point deadline;
+};
+
+#endif // PYRAMID_SEARCH_HPP
@@ -0,0 +1,52 @@
+#ifndef RING_QUEUE_HPP
+#define RING_QUEUE_HPP
+
+#include <vector>
+#include <cstddef>
+
+// FIFO queue over a power-of-two ring buffer. Pushing and popping never
+// shift elements; the buffer only doubles when the queue is full, so its
+// size follows the widest frontier rather than the number of pushes.
+//
+// This is not a fixed-capacity ring. A BFS frontier has no useful bound
+// below the map area, and sizing every queue to the map would allocate a
+// full map per search, so a full buffer doubles instead. That happens
+// O(log frontier) times per search.
+template<typename T>
+class RingQueue {
+    public:
+        RingQueue(size_t capacity = 1024){
+            size_t cap = 1;
+            while(cap < capacity) cap <<= 1;
+            buf.resize(cap);
+        }
+
+        bool empty() const { return head == tail; }
+        size_t size() const { return tail - head; }
+
+        void push(const T& val){
+            if(size() == buf.size()) grow();
+            buf[tail++ & (buf.size()-1)] = val;
+        }
+
+        T pop(){
+            return buf[head++ & (buf.size()-1)];
+        }
+
+        void clear(){ head = tail = 0; }
+
+    private:
+        void grow(){
+            std::vector<T> bigger(buf.size()*2);
+            size_t n = size();
+            for(size_t i = 0; i < n; i++) bigger[i] = buf[(head+i) & (buf.size()-1)];
+            buf.swap(bigger);
+            head = 0;
+            tail = n;
+        }
+
+        std::vector<T> buf;
+        size_t head = 0, tail = 0;
+};
+
+#endif // RING_QUEUE_HPP
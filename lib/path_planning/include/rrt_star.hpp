@@ -6,10 +6,11 @@
 #include <random>
 #include <complex>
 #include "map_data.hpp"
+#include "cell_layout.hpp"
 
 class RRTStar{
     public:
-        RRTStar(Graph g, int max_iter);
+        RRTStar(const PlanningGraph& g, int max_iter);
         void solve(cell sp, cell ep, int timeout);
         pair<vector<cell>, float> reconstruct_path(cell sp, cell ep);
         bool goal_reached;
@@ -17,19 +18,20 @@ class RRTStar{
 
     private:
         cell get_random_node();
-        cell get_nearest_node(vector<cell> node_list, cell random_node);
+        cell get_nearest_node(const vector<cell>& node_list, cell random_node);
         cell steer(cell from_node, cell to_node);
-        vector<cell> find_neighbors(vector<cell> node_list, cell node);
-        cell choose_parent(vector<cell> neighbors, cell nearest_node, cell new_node);
-        void rewire(cell new_node, vector<cell> neighbors);
+        vector<cell> find_neighbors(const vector<cell>& node_list, cell node);
+        cell choose_parent(const vector<cell>& neighbors, cell nearest_node, cell new_node);
+        void rewire(cell new_node, const vector<cell>& neighbors);
         float euclidean_distance(cell a, cell b);
-        Graph tree;
+        const PlanningGraph& tree;
         int max_iter;
-        map<cell, float> cost_map;
+        CellLayout layout;
+        CellArray<float> cost_map;
         vector<cell> node_list;
         vector<cell> all_valid_nodes;
-        vector<cell> travelled;
-        map<cell, cell> parent;
+        vector<cell_id> travelled;
+        CellArray<cell_id> parent;
 };
 
 #endif // RRT_STAR_HPP
\ No newline at end of file
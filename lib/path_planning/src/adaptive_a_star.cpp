@@ -0,0 +1,113 @@
+#include <mutex>
+#include <list>
+#include "adaptive_a_star.hpp"
+#include "best_first_search.hpp"
+
+using namespace std::chrono;
+
+// Learned heuristics, most recently used goal first. cache_mutex only guards
+// the list; each table has its own lock (see LearnedHeuristic).
+static std::mutex cache_mutex;
+static std::list<shared_ptr<LearnedHeuristic>> cache;
+
+// Table of the goal on the current map, added empty on the first query
+static shared_ptr<LearnedHeuristic> get_learned(const GridGraph& g, cell goal){
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    shared_ptr<LearnedHeuristic> table;
+    for(auto it = cache.begin(); it != cache.end(); it++){
+        if((*it)->goal != goal) continue;
+        if((*it)->matches(g)) table = *it;
+        cache.erase(it);
+        break;
+    }
+    if(!table) table = make_shared<LearnedHeuristic>(g, goal);
+    cache.push_front(table);
+    if(cache.size() > AdaptiveAStar::MAX_GOALS) cache.pop_back();
+    return table;
+}
+
+void AdaptiveAStar::clear_heuristics(){
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    cache.clear();
+}
+
+AdaptiveAStar::AdaptiveAStar(const PlanningGraph& g) : tree(g){
+    int width = tree.get_width(), height = tree.get_height();
+    free_cells = get_free_cells(g);
+    layout = CellLayout(width, height);
+    dist = CellArray<int>(width, height, UNREACHED);
+    parent = CellArray<cell_id>(width, height, cell_id());
+    state = CellArray<uint8_t>(width, height, UNSEEN);
+    open_set = IndexedHeap<>(width, height);
+}
+
+int AdaptiveAStar::get_heuristic(cell c, cell ep) const {
+    int h = OctileHeuristic::cost<int>(c, ep);
+    return learned ? std::max(h, learned->h[c]) : h;
+}
+
+void AdaptiveAStar::solve(cell sp, cell ep, int timeout){
+    if(!tree.is_node_valid(sp) || !tree.is_node_valid(ep)) return;
+    auto grid = dynamic_cast<const GridGraph*>(&tree);
+    if(grid) learned = get_learned(*grid, ep);
+    std::shared_lock<std::shared_mutex> read_lock;
+    if(learned) read_lock = std::shared_lock<std::shared_mutex>(learned->mutex);
+    cell_id start_id = layout.to_id(sp), goal_id = layout.to_id(ep);
+    dist[start_id] = 0;
+    state[start_id] = OPEN;
+    open_set.push(start_id, get_heuristic(sp, ep), 0);
+    int expanded = 0;
+    auto start = high_resolution_clock::now();
+    while(!open_set.empty()){
+        if(++expanded % TIMEOUT_CHECK_INTERVAL == 0){
+            auto now = high_resolution_clock::now();
+            if(duration_cast<milliseconds>(now-start).count() >= timeout) break;
+        }
+        cell_id curr = open_set.pop();
+        state[curr] = CLOSED;
+        if(curr == goal_id){
+            goal_reached = true;
+            break;
+        }
+        closed.push_back(curr);
+        for_each_neighbor<8>(tree, free_cells, layout.to_cell(curr), [&](cell child, int w){
+            cell_id cp = layout.to_id(child);
+            int new_dist = dist[curr] + w;
+            if(new_dist >= dist[cp]) return false;
+            if(state[cp] == UNSEEN) travelled.push_back(cp);
+            dist[cp] = new_dist;
+            parent[cp] = curr;
+            state[cp] = OPEN;
+            open_set.push(cp, new_dist + get_heuristic(child, ep), new_dist);
+            return false;
+        });
+    }
+    if(read_lock) read_lock.unlock();
+    if(goal_reached && learned) learn(goal_id);
+}
+
+// Raises the table of the goal to g(goal) - g(s) on the closed cells (the
+// max of admissible, consistent heuristics is both as well)
+void AdaptiveAStar::learn(cell_id goal_id){
+    int goal_dist = dist[goal_id];
+    std::unique_lock<std::shared_mutex> lock(learned->mutex);
+    for(auto id: closed) learned->h[id] = std::max(learned->h[id], goal_dist - dist[id]);
+}
+
+pair<vector<cell>, float> AdaptiveAStar::reconstruct_path(cell sp, cell ep){
+    auto data = pair<vector<cell>, float>();
+    for(cell_id curr = layout.to_id(ep); curr.is_valid(); curr = parent[curr]){
+        data.first.push_back(layout.to_cell(curr));
+    }
+    std::reverse(data.first.begin(), data.first.end());
+    if(data.first[0] != sp) data.first = vector<cell>();
+    data.second = dist[ep] == UNREACHED ? std::numeric_limits<float>::infinity() : dist[ep];
+    return data;
+}
+
+vector<cell> AdaptiveAStar::get_travelled_nodes(){
+    vector<cell> nodes;
+    nodes.reserve(travelled.size());
+    for(auto t: travelled) nodes.push_back(layout.to_cell(t));
+    return nodes;
+}
@@ -0,0 +1,123 @@
+#include "ara_star.hpp"
+#include "best_first_search.hpp"
+
+using namespace std::chrono;
+
+ARAStar::ARAStar(const PlanningGraph& g, float initial_weight, float weight_step)
+    : tree(g), initial_weight(std::max(initial_weight, 1.0f)), weight_step(std::max(weight_step, 0.01f)){
+    int width = tree.get_width(), height = tree.get_height();
+    free_cells = get_free_cells(g);
+    layout = CellLayout(width, height);
+    dist = CellArray<int>(width, height, UNREACHED);
+    parent = CellArray<cell_id>(width, height, cell_id());
+    state = CellArray<uint8_t>(width, height, UNSEEN);
+    open_set = IndexedHeap<>(width, height);
+}
+
+float ARAStar::get_key(cell_id id) const {
+    return dist[id] + weight*OctileHeuristic::cost<int>(layout.to_cell(id), goal);
+}
+
+// Expands until no open cell can improve the path to the goal under the
+// current weight. Returns false if the deadline passed first.
+bool ARAStar::improve_path(high_resolution_clock::time_point start, int deadline){
+    int expanded = 0;
+    while(!open_set.empty() && (dist[goal_id] == UNREACHED || get_key(goal_id) > open_set.top_key())){
+        if(++expanded % TIMEOUT_CHECK_INTERVAL == 0){
+            auto now = high_resolution_clock::now();
+            if(duration_cast<milliseconds>(now-start).count() >= deadline) return false;
+        }
+        cell_id curr = open_set.pop();
+        state[curr] = CLOSED;
+        closed.push_back(curr);
+        for_each_neighbor<8>(tree, free_cells, layout.to_cell(curr), [&](cell child, int w){
+            cell_id cp = layout.to_id(child);
+            int new_dist = dist[curr] + w;
+            if(new_dist >= dist[cp]) return false;
+            if(state[cp] == UNSEEN) travelled.push_back(cp);
+            dist[cp] = new_dist;
+            parent[cp] = curr;
+            if(state[cp] == CLOSED){
+                state[cp] = INCONS;
+                incons.push_back(cp);
+            }
+            else if(state[cp] != INCONS){
+                state[cp] = OPEN;
+                open_set.push(cp, get_key(cp), new_dist);
+            }
+            return false;
+        });
+    }
+    return true;
+}
+
+// The bound is the weight unless the cells left to expand already prove a
+// tighter one: g(goal) / min(g + h) over open and inconsistent cells
+void ARAStar::publish(int time){
+    if(dist[goal_id] == UNREACHED) return;
+    float lower = dist[goal_id];
+    auto visit = [&](cell_id id){
+        lower = std::min(lower, (float)(dist[id] + OctileHeuristic::cost<int>(layout.to_cell(id), goal)));
+    };
+    // The open list is ordered by the weighted key, so every open cell is looked at
+    open_set.for_each([&](cell_id id, float key){ visit(id); });
+    for(auto id: incons) visit(id);
+    float bound = lower > 0 ? std::min(weight, dist[goal_id]/lower) : 1;
+    ARASolution solution{weight, std::max(bound, 1.0f), 0, time, vector<cell>()};
+    for(cell_id curr = goal_id; curr.is_valid(); curr = parent[curr]) solution.path.push_back(layout.to_cell(curr));
+    std::reverse(solution.path.begin(), solution.path.end());
+    // Cells on the path may have improved after their children were labelled,
+    // so the path can be cheaper than g(goal)
+    for(size_t i = 1; i < solution.path.size(); i++) solution.dist += OctileHeuristic::cost<int>(solution.path[i-1], solution.path[i]);
+    solutions.push_back(solution);
+    goal_reached = true;
+}
+
+void ARAStar::solve(cell sp, cell ep, int deadline){
+    if(!tree.is_node_valid(sp) || !tree.is_node_valid(ep)) return;
+    auto start = high_resolution_clock::now();
+    goal = ep;
+    start_id = layout.to_id(sp);
+    goal_id = layout.to_id(ep);
+    weight = initial_weight;
+    dist[start_id] = 0;
+    state[start_id] = OPEN;
+    open_set.push(start_id, get_key(start_id), 0);
+    while(true){
+        bool finished = improve_path(start, deadline);
+        if(!finished) break;
+        publish(duration_cast<milliseconds>(high_resolution_clock::now()-start).count());
+        if(weight <= 1 || dist[goal_id] == UNREACHED) break;
+        if(!solutions.empty() && solutions.back().bound <= 1) break;
+
+        // Lower the weight and reopen the closed cells that improved
+        weight = std::max(weight - weight_step, 1.0f);
+        vector<cell_id> open_ids;
+        while(!open_set.empty()) open_ids.push_back(open_set.pop());
+        open_ids.insert(open_ids.end(), incons.begin(), incons.end());
+        incons.clear();
+        for(auto id: closed) if(state[id] == CLOSED) state[id] = SEEN;
+        closed.clear();
+        for(auto id: open_ids){
+            state[id] = OPEN;
+            open_set.push(id, get_key(id), dist[id]);
+        }
+    }
+}
+
+// Best path published before the deadline
+pair<vector<cell>, float> ARAStar::reconstruct_path(cell sp, cell ep){
+    auto data = pair<vector<cell>, float>();
+    data.second = std::numeric_limits<float>::infinity();
+    if(solutions.empty()) return data;
+    data.first = solutions.back().path;
+    data.second = solutions.back().dist;
+    return data;
+}
+
+vector<cell> ARAStar::get_travelled_nodes(){
+    vector<cell> nodes;
+    nodes.reserve(travelled.size());
+    for(auto t: travelled) nodes.push_back(layout.to_cell(t));
+    return nodes;
+}
@@ -0,0 +1,234 @@
+#include <thread>
+#include <cstring>
+#include "components.hpp"
+#include "best_first_search.hpp"
+
+// Layout of serialized labels: header, labels
+struct ComponentHeader {
+    int32_t width, height, num_components;
+    uint32_t next_label;
+};
+
+namespace {
+
+// Free cells [first, last] of one row
+struct Run {
+    int row, first, last;
+};
+
+int find_root(vector<int>& parent, int i){
+    while(parent[i] != i) i = parent[i] = parent[parent[i]];
+    return i;
+}
+
+void join(vector<int>& parent, int a, int b){
+    a = find_root(parent, a);
+    b = find_root(parent, b);
+    if(a != b) parent[std::max(a, b)] = std::min(a, b);
+}
+
+}
+
+void ComponentLabels::bind(const PlanningGraph& g){
+    tree = &g;
+    free_cells = get_free_cells(g);
+    auto grid = dynamic_cast<const GridGraph*>(&g);
+    map_version = grid ? grid->get_map_version() : 0;
+}
+
+bool ComponentLabels::is_free(int col, int row) const {
+    return free_cells ? free_cells->is_free(col, row) : tree->is_node_valid({col, row});
+}
+
+ComponentLabels::ComponentLabels(const PlanningGraph& g) : width(g.get_width()), height(g.get_height()){
+    bind(g);
+    label_all();
+}
+
+void ComponentLabels::label_all(){
+    labels.assign((size_t)width*height, NO_COMPONENT);
+    num_components = 0;
+    if(width == 0 || height == 0) return;
+
+    // Each band of rows is labeled independently: runs of a row are joined
+    // with the runs of the row above that they touch (8-connected, so runs
+    // one column apart diagonally touch too)
+    int num_bands = std::min<int>(height, std::max(1u, std::thread::hardware_concurrency()));
+    int band_rows = (height + num_bands-1)/num_bands;
+    num_bands = (height + band_rows-1)/band_rows;
+    vector<vector<Run>> runs(num_bands);
+    vector<vector<int>> parents(num_bands);
+    vector<vector<int>> row_start(num_bands);
+    auto label_band = [&](int b){
+        auto& band_runs = runs[b];
+        auto& parent = parents[b];
+        int first_row = b*band_rows, last_row = std::min(height, first_row + band_rows);
+        vector<pair<int, int>> row_runs;
+        for(int row = first_row; row < last_row; row++){
+            row_start[b].push_back(band_runs.size());
+            row_runs.clear();
+            if(free_cells) free_cells->row_runs(row, row_runs);
+            else{
+                for(int col = 0; col < width; col++){
+                    if(!is_free(col, row)) continue;
+                    int first = col;
+                    while(col+1 < width && is_free(col+1, row)) col++;
+                    row_runs.push_back({first, col});
+                }
+            }
+            for(auto r: row_runs){
+                band_runs.push_back({row, r.first, r.second});
+                parent.push_back(parent.size());
+            }
+            if(row == first_row) continue;
+            // Sweep the runs of this row against the runs of the row above
+            int above = row_start[b][row-first_row-1], above_end = row_start[b][row-first_row];
+            for(int i = above_end; i < (int)band_runs.size(); i++){
+                while(above < above_end && band_runs[above].last < band_runs[i].first-1) above++;
+                for(int j = above; j < above_end && band_runs[j].first <= band_runs[i].last+1; j++) join(parent, i, j);
+            }
+        }
+        row_start[b].push_back(band_runs.size());
+    };
+    vector<std::thread> threads;
+    for(int b = 1; b < num_bands; b++) threads.emplace_back(label_band, b);
+    label_band(0);
+    for(auto& t: threads) t.join();
+
+    // Merge the bands into one forest and join them along their borders
+    vector<int> offset(num_bands+1, 0);
+    for(int b = 0; b < num_bands; b++) offset[b+1] = offset[b] + runs[b].size();
+    vector<int> parent(offset[num_bands]);
+    for(int b = 0; b < num_bands; b++){
+        for(size_t i = 0; i < parents[b].size(); i++) parent[offset[b] + i] = offset[b] + find_root(parents[b], i);
+    }
+    for(int b = 1; b < num_bands; b++){
+        auto& upper = runs[b-1];
+        auto& lower = runs[b];
+        int above = row_start[b-1][row_start[b-1].size()-2], above_end = upper.size();
+        int below_end = row_start[b][1];
+        for(int i = 0; i < below_end; i++){
+            while(above < above_end && upper[above].last < lower[i].first-1) above++;
+            for(int j = above; j < above_end && upper[j].first <= lower[i].last+1; j++){
+                join(parent, offset[b] + i, offset[b-1] + j);
+            }
+        }
+    }
+
+    // Roots get new labels, then every band writes the labels of its cells
+    vector<uint32_t> run_label(parent.size());
+    for(size_t i = 0; i < parent.size(); i++){
+        int root = find_root(parent, i);
+        if(root == (int)i){
+            run_label[i] = next_label++;
+            num_components++;
+        }
+        else run_label[i] = run_label[root];
+    }
+    auto write_band = [&](int b){
+        for(size_t i = 0; i < runs[b].size(); i++){
+            auto& r = runs[b][i];
+            std::fill(labels.begin() + (size_t)r.row*width + r.first, labels.begin() + (size_t)r.row*width + r.last+1, run_label[offset[b] + i]);
+        }
+    };
+    threads.clear();
+    for(int b = 1; b < num_bands; b++) threads.emplace_back(write_band, b);
+    write_band(0);
+    for(auto& t: threads) t.join();
+}
+
+// Every free cell next to an edited cell lies in the rects grown by one, so
+// flooding from the free cells there reaches every piece of the components
+// that may have split or merged. Cells of other components keep their label.
+// Once the flood outgrows the budget the whole map is labeled again instead.
+int ComponentLabels::update(const PlanningGraph& g, const vector<CellRect>& changed){
+    bind(g);
+    if(g.get_width() != width || g.get_height() != height){
+        width = g.get_width();
+        height = g.get_height();
+        label_all();
+        return width*height;
+    }
+    size_t budget = (size_t)width*height/FLOOD_BUDGET_FRACTION;
+    vector<uint32_t> affected;
+    vector<CellRect> grown;
+    for(auto rect: changed){
+        int x0 = std::max(rect.col-1, 0), x1 = std::min(rect.col+rect.width, width-1);
+        int y0 = std::max(rect.row-1, 0), y1 = std::min(rect.row+rect.height, height-1);
+        if(x0 > x1 || y0 > y1) continue;
+        grown.push_back({x0, y0, x1-x0+1, y1-y0+1});
+        for(int row = y0; row <= y1; row++){
+            for(int col = x0; col <= x1; col++){
+                uint32_t& label = labels[(size_t)row*width + col];
+                if(label != NO_COMPONENT && std::find(affected.begin(), affected.end(), label) == affected.end()){
+                    affected.push_back(label);
+                }
+                if(!is_free(col, row)) label = NO_COMPONENT;
+            }
+        }
+    }
+    num_components -= affected.size();
+
+    size_t relabeled = 0;
+    vector<int> stack;
+    // New labels start at first_new, so cells already flooded are skipped
+    // without searching affected
+    uint32_t first_new = next_label;
+    auto claimable = [&](uint32_t label){
+        return label == NO_COMPONENT || (label < first_new && std::find(affected.begin(), affected.end(), label) != affected.end());
+    };
+    for(auto rect: grown){
+        for(int row = rect.row; row < rect.row+rect.height; row++){
+            for(int col = rect.col; col < rect.col+rect.width; col++){
+                if(!is_free(col, row) || !claimable(labels[(size_t)row*width + col])) continue;
+                uint32_t label = next_label++;
+                num_components++;
+                labels[(size_t)row*width + col] = label;
+                stack.push_back(row*width + col);
+                while(!stack.empty()){
+                    int id = stack.back();
+                    stack.pop_back();
+                    if(++relabeled > budget){
+                        label_all();
+                        return width*height;
+                    }
+                    for_each_neighbor<8>(*tree, free_cells, {id%width, id/width}, [&](cell child, int w){
+                        int child_id = child.second*width + child.first;
+                        if(claimable(labels[child_id])){
+                            labels[child_id] = label;
+                            stack.push_back(child_id);
+                        }
+                        return false;
+                    });
+                }
+            }
+        }
+    }
+    return relabeled;
+}
+
+vector<char> ComponentLabels::serialize() const {
+    ComponentHeader header = {width, height, num_components, next_label};
+    vector<char> data(sizeof(header) + labels.size()*sizeof(uint32_t));
+    std::memcpy(data.data(), &header, sizeof(header));
+    std::memcpy(data.data() + sizeof(header), labels.data(), labels.size()*sizeof(uint32_t));
+    return data;
+}
+
+shared_ptr<ComponentLabels> ComponentLabels::deserialize(const void* data, size_t size, const PlanningGraph& g){
+    if(!data || size < sizeof(ComponentHeader)) return nullptr;
+    ComponentHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    size_t num_cells = (size_t)header.width*header.height;
+    if(header.width != g.get_width() || header.height != g.get_height() || header.num_components < 0 ||
+       size != sizeof(header) + num_cells*sizeof(uint32_t)) return nullptr;
+    auto components = shared_ptr<ComponentLabels>(new ComponentLabels());
+    components->bind(g);
+    components->width = header.width;
+    components->height = header.height;
+    components->num_components = header.num_components;
+    components->next_label = header.next_label;
+    components->labels.resize(num_cells);
+    std::memcpy(components->labels.data(), static_cast<const char*>(data) + sizeof(header), num_cells*sizeof(uint32_t));
+    return components;
+}
@@ -0,0 +1,479 @@
+#include <queue>
+#include <cstring>
+#include <mutex>
+#include "contraction_hierarchy.hpp"
+#include "best_first_search.hpp"
+
+using namespace std::chrono;
+
+static const int INF = std::numeric_limits<int>::max();
+typedef std::priority_queue<pair<int, int>, vector<pair<int, int>>, std::greater<pair<int, int>>> MinQueue;
+
+// Layout of a serialized hierarchy: header, rectangles, node cells, offsets, edges
+struct CHHeader {
+    int32_t width, height, num_rects, num_nodes, num_edges, num_core;
+    uint64_t num_shortcuts;
+};
+
+namespace {
+
+// Graph being contracted. Every edge is stored at both ends; contracted
+// nodes are removed from the lists.
+struct Contraction {
+    struct Shortcut {
+        int from, to, weight;
+    };
+
+    Contraction(int n) : adj(n), witness_dist(n, INF) {}
+
+    // Dijkstra from source around skip, settling at most limit nodes and
+    // nothing further than max_dist
+    void witness_search(int source, int skip, int max_dist, int limit){
+        for(int t: witness_touched) witness_dist[t] = INF;
+        witness_touched.clear();
+        MinQueue q;
+        witness_dist[source] = 0;
+        witness_touched.push_back(source);
+        q.push({0, source});
+        int settled = 0;
+        while(!q.empty() && settled < limit){
+            auto [d, u] = q.top();
+            q.pop();
+            if(d > witness_dist[u]) continue;
+            if(d > max_dist) break;
+            settled++;
+            for(auto& e: adj[u]){
+                if(e.target == skip || d + e.weight >= witness_dist[e.target]) continue;
+                if(witness_dist[e.target] == INF) witness_touched.push_back(e.target);
+                witness_dist[e.target] = d + e.weight;
+                q.push({d + e.weight, e.target});
+            }
+        }
+    }
+
+    // Shortcuts needed to contract v (each neighbor pair once)
+    void find_shortcuts(int v, vector<Shortcut>& shortcuts){
+        shortcuts.clear();
+        auto& edges = adj[v];
+        int max_weight = 0;
+        for(auto& e: edges) max_weight = std::max(max_weight, e.weight);
+        for(size_t i = 0; i+1 < edges.size(); i++){
+            witness_search(edges[i].target, v, edges[i].weight + max_weight, ContractionHierarchy::WITNESS_LIMIT);
+            for(size_t j = i+1; j < edges.size(); j++){
+                int via = edges[i].weight + edges[j].weight;
+                if(witness_dist[edges[j].target] > via) shortcuts.push_back({edges[i].target, edges[j].target, via});
+            }
+        }
+    }
+
+    // Edge difference, plus contracted neighbors and hierarchy level which
+    // spread contraction evenly over the map
+    int get_priority(int v){
+        find_shortcuts(v, scratch);
+        return 4*((int)scratch.size() - (int)adj[v].size()) + deleted[v] + level[v];
+    }
+
+    // Adds or shortens edge (a,b); true if it is a new edge
+    bool add_edge(int a, int b, int weight, int middle){
+        for(auto& e: adj[a]){
+            if(e.target != b) continue;
+            if(weight < e.weight){
+                e.weight = weight;
+                e.middle = middle;
+            }
+            return false;
+        }
+        adj[a].push_back({b, weight, middle});
+        return true;
+    }
+
+    vector<vector<ContractionHierarchy::Edge>> adj;
+    vector<int> witness_dist, witness_touched, deleted, level;
+    vector<Shortcut> scratch;
+};
+
+}
+
+// Moving diagonally costs as much as two straight moves, which is what lets
+// shortest paths skip the inside of rectangles
+static_assert(MapData::DIR_WEIGHT[MAX_NEIGHBORS-1] == 2*MapData::DIR_WEIGHT[0], "Rectangle reduction needs L1 move costs");
+
+ContractionHierarchy::ContractionHierarchy(const PlanningGraph& g)
+    : width(g.get_width()), height(g.get_height()){
+    // Greedy rectangles: extend right, then down while the whole row is free
+    rect_of.assign((size_t)width*height, -1);
+    vector<char> free_cell((size_t)width*height);
+    for(int row = 0; row < height; row++){
+        for(int col = 0; col < width; col++) free_cell[(size_t)row*width + col] = g.is_node_valid({col, row});
+    }
+    auto open = [&](int col, int row){
+        size_t i = (size_t)row*width + col;
+        return free_cell[i] && rect_of[i] < 0;
+    };
+    for(int row = 0; row < height; row++){
+        for(int col = 0; col < width; col++){
+            if(!open(col, row)) continue;
+            CellRect r = {col, row, 1, 1};
+            while(r.col + r.width < width && open(r.col + r.width, row)) r.width++;
+            while(r.row + r.height < height){
+                bool row_open = true;
+                for(int x = r.col; x < r.col + r.width && row_open; x++) row_open = open(x, r.row + r.height);
+                if(!row_open) break;
+                r.height++;
+            }
+            for(int y = r.row; y < r.row + r.height; y++){
+                std::fill(rect_of.begin() + (size_t)y*width + r.col, rect_of.begin() + (size_t)y*width + r.col + r.width, (int)rects.size());
+            }
+            rects.push_back(r);
+        }
+    }
+
+    // Border cells are the nodes
+    node_of.assign((size_t)width*height, -1);
+    for(auto& r: rects){
+        for(int y = r.row; y < r.row + r.height; y++){
+            for(int x = r.col; x < r.col + r.width; x++){
+                if(y != r.row && y != r.row + r.height-1 && x != r.col && x != r.col + r.width-1) continue;
+                node_of[(size_t)y*width + x] = node_cells.size();
+                node_cells.push_back({x, y});
+            }
+        }
+    }
+    int n = node_cells.size();
+
+    Contraction c(n);
+    c.deleted.assign(n, 0);
+    c.level.assign(n, 0);
+    auto free_cells = get_free_cells(g);
+    for(int i = 0; i < n; i++){
+        for_each_neighbor<8>(g, free_cells, node_cells[i], [&](cell nc, int w){
+            if(get_node(nc) >= 0) c.adj[i].push_back({get_node(nc), w, -1});
+            return false;
+        });
+    }
+    // Straight edges across rectangles
+    auto add_line = [&](cell a, cell b){
+        int w = (std::abs(a.first - b.first) + std::abs(a.second - b.second))*MapData::DIR_WEIGHT[0];
+        c.adj[get_node(a)].push_back({get_node(b), w, -1});
+        c.adj[get_node(b)].push_back({get_node(a), w, -1});
+    };
+    for(auto& r: rects){
+        if(r.width > 2){
+            for(int y = r.row; y < r.row + r.height; y++) add_line({r.col, y}, {r.col + r.width-1, y});
+        }
+        if(r.height > 2){
+            for(int x = r.col; x < r.col + r.width; x++) add_line({x, r.row}, {x, r.row + r.height-1});
+        }
+    }
+    size_t degree_sum = 0;
+    for(int i = 0; i < n; i++) degree_sum += c.adj[i].size();
+
+    // Contract in order of priority. Neighbors are re-prioritized after each
+    // contraction and a popped node is re-evaluated (lazy update) in case
+    // the graph around it changed since. Once the remaining nodes get dense
+    // contraction stops; they form the core and keep all their edges
+    MinQueue order;
+    vector<int> priority(n);
+    for(int i = 0; i < n; i++){
+        priority[i] = c.get_priority(i);
+        order.push({priority[i], i});
+    }
+    vector<int> rank(n, -1);
+    vector<vector<Edge>> upward(n);
+    int next_rank = 0;
+    while(!order.empty()){
+        auto [p, v] = order.top();
+        order.pop();
+        if(rank[v] >= 0 || p != priority[v]) continue;
+        if(degree_sum > (size_t)CORE_DEGREE*(n - next_rank)) break;
+        priority[v] = c.get_priority(v);
+        if(priority[v] > p && !order.empty() && priority[v] > order.top().first){
+            order.push({priority[v], v});
+            continue;
+        }
+        rank[v] = next_rank++;
+        auto shortcuts = std::move(c.scratch);
+        upward[v] = std::move(c.adj[v]);
+        c.adj[v].clear();
+        degree_sum -= 2*upward[v].size();
+        for(auto& e: upward[v]){
+            auto& list = c.adj[e.target];
+            for(size_t k = 0; k < list.size(); k++){
+                if(list[k].target != v) continue;
+                list[k] = list.back();
+                list.pop_back();
+                break;
+            }
+            c.deleted[e.target]++;
+            c.level[e.target] = std::max(c.level[e.target], c.level[v]+1);
+        }
+        for(auto& s: shortcuts){
+            if(c.add_edge(s.from, s.to, s.weight, v)) degree_sum += 2;
+            c.add_edge(s.to, s.from, s.weight, v);
+        }
+        num_shortcuts += shortcuts.size();
+        for(auto& e: upward[v]){
+            priority[e.target] = c.get_priority(e.target);
+            order.push({priority[e.target], e.target});
+        }
+    }
+    for(int i = 0; i < n; i++){
+        if(rank[i] >= 0) continue;
+        rank[i] = next_rank++;
+        upward[i] = std::move(c.adj[i]);
+        num_core++;
+    }
+
+    // Renumber nodes by rank and keep the upward edges in CSR form
+    vector<cell> cells(n);
+    for(int i = 0; i < n; i++) cells[rank[i]] = node_cells[i];
+    offsets.assign(n+1, 0);
+    for(int i = 0; i < n; i++) offsets[rank[i]+1] = upward[i].size();
+    for(int i = 0; i < n; i++) offsets[i+1] += offsets[i];
+    edges.resize(offsets[n]);
+    for(int i = 0; i < n; i++){
+        int k = offsets[rank[i]];
+        for(auto& e: upward[i]) edges[k++] = Edge{rank[e.target], e.weight, e.middle < 0 ? -1 : rank[e.middle]};
+    }
+    node_cells = std::move(cells);
+    build_index();
+}
+
+void ContractionHierarchy::build_index(){
+    rect_of.assign((size_t)width*height, -1);
+    for(size_t i = 0; i < rects.size(); i++){
+        auto& r = rects[i];
+        for(int y = r.row; y < r.row + r.height; y++){
+            std::fill(rect_of.begin() + (size_t)y*width + r.col, rect_of.begin() + (size_t)y*width + r.col + r.width, (int)i);
+        }
+    }
+    node_of.assign((size_t)width*height, -1);
+    for(size_t i = 0; i < node_cells.size(); i++) node_of[(size_t)node_cells[i].second*width + node_cells[i].first] = i;
+}
+
+// Straight lines from an inner cell to each border of its rectangle
+void ContractionHierarchy::get_access_nodes(cell c, vector<pair<int, int>>& nodes) const {
+    nodes.clear();
+    int r = get_rect(c);
+    if(r < 0) return;
+    if(get_node(c) >= 0){
+        nodes.push_back({get_node(c), 0});
+        return;
+    }
+    auto& rect = rects[r];
+    cell ends[4] = {{rect.col, c.second}, {rect.col + rect.width-1, c.second}, {c.first, rect.row}, {c.first, rect.row + rect.height-1}};
+    for(auto e: ends){
+        nodes.push_back({get_node(e), (std::abs(e.first - c.first) + std::abs(e.second - c.second))*MapData::DIR_WEIGHT[0]});
+    }
+}
+
+bool ContractionHierarchy::matches(const FreeBitmap& free_cells) const {
+    if(free_cells.get_width() != width || free_cells.get_height() != height) return false;
+    for(int row = 0; row < height; row++){
+        for(int col = 0; col < width; col++){
+            if(free_cells.is_free(col, row) != (rect_of[(size_t)row*width + col] >= 0)) return false;
+        }
+    }
+    return true;
+}
+
+shared_ptr<const ContractionHierarchy> ContractionHierarchy::get_contraction_hierarchy(const GridGraph& g){
+    static std::mutex cache_mutex;
+    static shared_ptr<const ContractionHierarchy> cached;
+    static uint64_t cached_version = 0;
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    uint64_t version = g.get_map_version();
+    if(cached && version == cached_version && cached->matches(g.get_free_bitmap())) return cached;
+    cached = make_shared<const ContractionHierarchy>(g);
+    cached_version = version;
+    return cached;
+}
+
+void append_line(cell a, cell b, vector<cell>& path){
+    while(a != b){
+        a.first += (b.first > a.first) - (b.first < a.first);
+        a.second += (b.second > a.second) - (b.second < a.second);
+        path.push_back(a);
+    }
+}
+
+// An edge is stored at its lower endpoint; shortcuts are split at the node
+// they skip until only straight lines are left
+void ContractionHierarchy::unpack(int a, int b, vector<cell>& path) const {
+    vector<pair<int, int>> stack = {{a, b}};
+    while(!stack.empty()){
+        auto [x, y] = stack.back();
+        stack.pop_back();
+        int lo = std::min(x, y), hi = std::max(x, y), middle = -1;
+        for(auto e = edges_begin(lo); e != edges_end(lo); e++){
+            if(e->target == hi){
+                middle = e->middle;
+                break;
+            }
+        }
+        if(middle < 0) append_line(node_cells[x], node_cells[y], path);
+        else{
+            stack.push_back({middle, y});
+            stack.push_back({x, middle});
+        }
+    }
+}
+
+vector<char> ContractionHierarchy::serialize() const {
+    CHHeader header = {width, height, (int32_t)rects.size(), (int32_t)node_cells.size(), (int32_t)edges.size(), num_core, num_shortcuts};
+    vector<int32_t> cells;
+    for(auto c: node_cells){
+        cells.push_back(c.first);
+        cells.push_back(c.second);
+    }
+    size_t sizes[5] = {sizeof(header), rects.size()*sizeof(CellRect), cells.size()*sizeof(int32_t),
+                       offsets.size()*sizeof(int32_t), edges.size()*sizeof(Edge)};
+    vector<char> data(sizes[0] + sizes[1] + sizes[2] + sizes[3] + sizes[4]);
+    char* p = data.data();
+    std::memcpy(p, &header, sizes[0]);
+    std::memcpy(p += sizes[0], rects.data(), sizes[1]);
+    std::memcpy(p += sizes[1], cells.data(), sizes[2]);
+    std::memcpy(p += sizes[2], offsets.data(), sizes[3]);
+    std::memcpy(p += sizes[3], edges.data(), sizes[4]);
+    return data;
+}
+
+shared_ptr<ContractionHierarchy> ContractionHierarchy::deserialize(const void* data, size_t size, const PlanningGraph& g){
+    if(!data || size < sizeof(CHHeader)) return nullptr;
+    CHHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if(header.width != g.get_width() || header.height != g.get_height() || header.num_rects < 0 ||
+       header.num_nodes < 0 || header.num_edges < 0) return nullptr;
+    size_t sizes[4] = {(size_t)header.num_rects*sizeof(CellRect), 2*(size_t)header.num_nodes*sizeof(int32_t),
+                       ((size_t)header.num_nodes+1)*sizeof(int32_t), (size_t)header.num_edges*sizeof(Edge)};
+    if(size != sizeof(header) + sizes[0] + sizes[1] + sizes[2] + sizes[3]) return nullptr;
+    auto ch = shared_ptr<ContractionHierarchy>(new ContractionHierarchy());
+    ch->width = header.width;
+    ch->height = header.height;
+    ch->num_core = header.num_core;
+    ch->num_shortcuts = header.num_shortcuts;
+    auto p = static_cast<const char*>(data) + sizeof(header);
+    ch->rects.resize(header.num_rects);
+    std::memcpy(ch->rects.data(), p, sizes[0]);
+    for(auto& r: ch->rects){
+        if(r.col < 0 || r.row < 0 || r.width < 1 || r.height < 1 || r.col + r.width > ch->width || r.row + r.height > ch->height) return nullptr;
+    }
+    vector<int32_t> cells(2*header.num_nodes);
+    std::memcpy(cells.data(), p += sizes[0], sizes[1]);
+    for(int i = 0; i < header.num_nodes; i++){
+        cell c = {cells[2*i], cells[2*i+1]};
+        if(c.first < 0 || c.first >= ch->width || c.second < 0 || c.second >= ch->height) return nullptr;
+        ch->node_cells.push_back(c);
+    }
+    ch->offsets.resize(header.num_nodes+1);
+    std::memcpy(ch->offsets.data(), p += sizes[1], sizes[2]);
+    ch->edges.resize(header.num_edges);
+    std::memcpy(ch->edges.data(), p + sizes[2], sizes[3]);
+    if(ch->offsets.front() != 0 || ch->offsets.back() != header.num_edges) return nullptr;
+    ch->build_index();
+    return ch;
+}
+
+CHSearch::CHSearch(const PlanningGraph& g, shared_ptr<const ContractionHierarchy> ch) : ch(ch){
+    for(int side = 0; side < 2; side++){
+        dist[side].assign(ch->get_num_nodes(), INF);
+        parent[side].assign(ch->get_num_nodes(), -1);
+    }
+}
+
+void CHSearch::solve(cell sp, cell ep, int timeout){
+    for(int t: touched){
+        dist[0][t] = dist[1][t] = INF;
+        parent[0][t] = parent[1][t] = -1;
+    }
+    touched.clear();
+    goal_reached = false;
+    meet = -1;
+    best = INF;
+    int start_rect = ch->get_rect(sp), goal_rect = ch->get_rect(ep);
+    if(start_rect < 0 || goal_rect < 0) return;
+    // Inside one rectangle the straight-line distance can not be beaten
+    same_rect = start_rect == goal_rect;
+    if(same_rect){
+        best = (std::abs(sp.first - ep.first) + std::abs(sp.second - ep.second))*MapData::DIR_WEIGHT[0];
+        goal_reached = true;
+        return;
+    }
+    MinQueue q[2];
+    cell ends[2] = {sp, ep};
+    for(int side = 0; side < 2; side++){
+        ch->get_access_nodes(ends[side], access);
+        for(auto [node, d]: access){
+            if(d >= dist[side][node]) continue;
+            if(dist[0][node] == INF && dist[1][node] == INF) touched.push_back(node);
+            dist[side][node] = d;
+            q[side].push({d, node});
+        }
+    }
+    int expanded = 0;
+    auto start = high_resolution_clock::now();
+    while(true){
+        // Grow the side with the smaller key; a side is done once its
+        // smallest key can not beat the best meeting node
+        for(int side = 0; side < 2; side++){
+            while(!q[side].empty() && q[side].top().first > dist[side][q[side].top().second]) q[side].pop();
+            if(!q[side].empty() && q[side].top().first >= best) q[side] = MinQueue();
+        }
+        if(q[0].empty() && q[1].empty()) break;
+        int side = q[1].empty() || (!q[0].empty() && q[0].top().first <= q[1].top().first) ? 0 : 1;
+        if(++expanded % TIMEOUT_CHECK_INTERVAL == 0){
+            auto now = high_resolution_clock::now();
+            if(duration_cast<milliseconds>(now-start).count() >= timeout) break;
+        }
+        auto [d, u] = q[side].top();
+        q[side].pop();
+        if(dist[1-side][u] != INF && d + dist[1-side][u] < best){
+            best = d + dist[1-side][u];
+            meet = u;
+        }
+        // Stall on demand: edges are symmetric, so a shorter way to u from
+        // a higher node means u is not on a shortest up-down path
+        bool stalled = false;
+        for(auto e = ch->edges_begin(u); e != ch->edges_end(u) && !stalled; e++){
+            stalled = dist[side][e->target] != INF && dist[side][e->target] + e->weight < d;
+        }
+        if(stalled) continue;
+        for(auto e = ch->edges_begin(u); e != ch->edges_end(u); e++){
+            int nd = d + e->weight;
+            if(nd >= dist[side][e->target]) continue;
+            if(dist[0][e->target] == INF && dist[1][e->target] == INF) touched.push_back(e->target);
+            dist[side][e->target] = nd;
+            parent[side][e->target] = u;
+            q[side].push({nd, e->target});
+        }
+    }
+    goal_reached = meet >= 0;
+}
+
+pair<vector<cell>, float> CHSearch::reconstruct_path(cell sp, cell ep){
+    auto data = pair<vector<cell>, float>();
+    data.second = std::numeric_limits<float>::infinity();
+    if(!goal_reached) return data;
+    data.first.push_back(sp);
+    data.second = best;
+    if(same_rect){
+        append_line(sp, ep, data.first);
+        return data;
+    }
+    vector<int> up;
+    for(int u = meet; u >= 0; u = parent[0][u]) up.push_back(u);
+    std::reverse(up.begin(), up.end());
+    append_line(sp, ch->get_cell(up[0]), data.first);
+    for(size_t i = 1; i < up.size(); i++) ch->unpack(up[i-1], up[i], data.first);
+    int u = meet;
+    for(; parent[1][u] >= 0; u = parent[1][u]) ch->unpack(u, parent[1][u], data.first);
+    append_line(ch->get_cell(u), ep, data.first);
+    return data;
+}
+
+vector<cell> CHSearch::get_travelled_nodes(){
+    vector<cell> nodes;
+    nodes.reserve(touched.size());
+    for(auto t: touched) nodes.push_back(ch->get_cell(t));
+    return nodes;
+}
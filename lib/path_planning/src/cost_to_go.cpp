@@ -0,0 +1,119 @@
+#include "cost_to_go.hpp"
+#include "best_first_search.hpp"
+
+CostToGoField::CostToGoField(const PlanningGraph& g, cell goal)
+    : goal(goal), width(g.get_width()), height(g.get_height()), dist(g.get_width(), g.get_height(), UNREACHED_DIST){
+    auto grid = dynamic_cast<const GridGraph*>(&g);
+    map_version = grid ? grid->get_map_version() : 0;
+    update_distance_field(g, goal, dist);
+}
+
+pair<vector<cell>, float> CostToGoField::descend(const PlanningGraph& g, cell start) const {
+    auto data = pair<vector<cell>, float>();
+    data.second = std::numeric_limits<float>::infinity();
+    if(!reachable(start)) return data;
+    const FreeBitmap* free_cells = get_free_cells(g);
+    cell c = start;
+    data.first.push_back(c);
+    while(c != goal){
+        // Dijkstra leaves every cell a neighbor it was reached through
+        int d = dist[c];
+        cell next = c;
+        for_each_neighbor<8>(g, free_cells, c, [&](cell child, int w){
+            if(dist[child] != UNREACHED_DIST && dist[child] + w == d){
+                next = child;
+                return true;
+            }
+            return false;
+        });
+        if(next == c) return pair<vector<cell>, float>(vector<cell>(), data.second); // g is not the graph of the field
+        c = next;
+        data.first.push_back(c);
+    }
+    data.second = dist[start];
+    return data;
+}
+
+shared_ptr<const CostToGoField> CostToGoCache::get_field(const GridGraph& g, cell goal){
+    Key key = {g.get_map_version(), goal};
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(key);
+        if(it != index.end()){
+            hits++;
+            entries.splice(entries.begin(), entries, it->second);
+            return it->second->field;
+        }
+        misses++;
+    }
+    // Built without the lock so other goals are served meanwhile
+    auto field = make_shared<const CostToGoField>(g, goal);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(key);
+    if(it != index.end()){
+        // Another thread built it first
+        entries.splice(entries.begin(), entries, it->second);
+        return it->second->field;
+    }
+    entries.push_front(Entry{key, field});
+    index[key] = entries.begin();
+    memory_used += field->get_memory();
+    while(memory_used > memory_budget && entries.size() > 1){
+        auto& oldest = entries.back();
+        memory_used -= oldest.field->get_memory();
+        index.erase(oldest.key);
+        entries.pop_back();
+    }
+    return field;
+}
+
+void CostToGoCache::clear(){
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+    memory_used = 0;
+}
+
+size_t CostToGoCache::get_memory_used() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return memory_used;
+}
+
+int CostToGoCache::get_num_fields() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+int CostToGoCache::get_hits() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+int CostToGoCache::get_misses() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
+
+shared_ptr<CostToGoCache> CostToGoCache::get_shared_cache(){
+    static shared_ptr<CostToGoCache> shared = make_shared<CostToGoCache>();
+    return shared;
+}
+
+CostToGoSearch::CostToGoSearch(const GridGraph& g, shared_ptr<CostToGoCache> cache) : tree(&g), cache(cache) {}
+
+void CostToGoSearch::solve(cell sp, cell ep, int timeout){
+    goal_reached = false;
+    result = pair<vector<cell>, float>(vector<cell>(), std::numeric_limits<float>::infinity());
+    if(!tree->is_node_valid(sp) || !tree->is_node_valid(ep)) return;
+    field = cache->get_field(*tree, ep);
+    result = field->descend(*tree, sp);
+    goal_reached = !result.first.empty();
+}
+
+pair<vector<cell>, float> CostToGoSearch::reconstruct_path(cell sp, cell ep){
+    return result;
+}
+
+vector<cell> CostToGoSearch::get_travelled_nodes(){
+    return result.first;
+}
@@ -0,0 +1,194 @@
+#include "d_star_lite.hpp"
+#include "best_first_search.hpp"
+
+using namespace std::chrono;
+
+static int add_cost(int w, int dist){
+    return dist == std::numeric_limits<int>::max() ? dist : w + dist;
+}
+
+DStarLite::DStarLite(const PlanningGraph& g){
+    int width = g.get_width(), height = g.get_height();
+    layout = CellLayout(width, height);
+    this->g = CellArray<int>(width, height, UNREACHED);
+    rhs = CellArray<int>(width, height, UNREACHED);
+    open_set = IndexedHeap<>(width, height);
+    bind(g);
+}
+
+void DStarLite::bind(const PlanningGraph& g){
+    tree = &g;
+    free_cells = get_free_cells(g);
+    auto grid = dynamic_cast<const GridGraph*>(&g);
+    map_version = grid ? grid->get_map_version() : 0;
+}
+
+bool DStarLite::is_free(cell c) const {
+    return free_cells ? free_cells->is_free(c.first, c.second) : tree->is_node_valid(c);
+}
+
+void DStarLite::reset(cell ep){
+    g.fill(UNREACHED);
+    rhs.fill(UNREACHED);
+    open_set.clear();
+    km = 0;
+    goal = ep;
+    goal_id = layout.to_id(ep);
+    rhs[goal_id] = 0;
+    open_set.push(goal_id, OctileHeuristic::cost<int>(start, goal), 0);
+    initialized = true;
+}
+
+// Keys sort on (k1, k2); the heap pops larger ties first so k2 is negated
+DStarLite::Key DStarLite::get_key(cell_id id) const {
+    int k2 = std::min(g[id], rhs[id]);
+    if(k2 == UNREACHED) return Key{UNREACHED, UNREACHED};
+    return Key{k2 + OctileHeuristic::cost<int>(start, layout.to_cell(id)) + km, k2};
+}
+
+// One step lookahead: cheapest cost to go through a neighbor of c
+int DStarLite::get_min_successor(cell c) const {
+    int best = UNREACHED;
+    for_each_neighbor<8>(*tree, free_cells, c, [&](cell n, int w){
+        best = std::min(best, add_cost(w, g[layout.to_id(n)]));
+        return false;
+    });
+    return best;
+}
+
+void DStarLite::update_vertex(cell_id id){
+    if(g[id] != rhs[id]){
+        Key k = get_key(id);
+        open_set.remove(id);
+        open_set.push(id, k.k1, -k.k2);
+    }
+    else open_set.remove(id);
+}
+
+void DStarLite::compute_shortest_path(int timeout){
+    cell_id start_id = layout.to_id(start);
+    int expanded = 0;
+    auto start_time = high_resolution_clock::now();
+    while(!open_set.empty()){
+        Key top = Key{(int)open_set.top_key(), -(int)open_set.top_tie()};
+        if(!(top < get_key(start_id)) && rhs[start_id] == g[start_id]) break;
+        if(++expanded % TIMEOUT_CHECK_INTERVAL == 0){
+            auto now = high_resolution_clock::now();
+            if(duration_cast<milliseconds>(now-start_time).count() >= timeout) return;
+        }
+        cell_id u = open_set.top();
+        cell uc = layout.to_cell(u);
+        Key k_new = get_key(u);
+        if(top < k_new){
+            open_set.remove(u);
+            open_set.push(u, k_new.k1, -k_new.k2);
+            continue;
+        }
+        open_set.pop();
+        travelled.push_back(u);
+        if(g[u] > rhs[u]){
+            // Overconsistent: the cost to go dropped, pass it on
+            g[u] = rhs[u];
+            for_each_neighbor<8>(*tree, free_cells, uc, [&](cell n, int w){
+                cell_id s = layout.to_id(n);
+                if(s != goal_id && add_cost(w, g[u]) < rhs[s]){
+                    rhs[s] = add_cost(w, g[u]);
+                    update_vertex(s);
+                }
+                return false;
+            });
+        }
+        else{
+            // Underconsistent: the cost to go rose, so every node that went
+            // through u looks for another way
+            int g_old = g[u];
+            g[u] = UNREACHED;
+            for_each_neighbor<8>(*tree, free_cells, uc, [&](cell n, int w){
+                cell_id s = layout.to_id(n);
+                if(s != goal_id && rhs[s] == add_cost(w, g_old)){
+                    rhs[s] = is_free(n) ? get_min_successor(n) : UNREACHED;
+                }
+                update_vertex(s);
+                return false;
+            });
+            if(u != goal_id) rhs[u] = is_free(uc) ? get_min_successor(uc) : UNREACHED;
+            update_vertex(u);
+        }
+    }
+    goal_reached = g[start_id] != UNREACHED;
+}
+
+void DStarLite::solve(cell sp, cell ep, int timeout){
+    goal_reached = false;
+    travelled.clear();
+    if(!tree->is_node_valid(sp) || !tree->is_node_valid(ep)) return;
+    if(!initialized || ep != goal){
+        start = sp;
+        reset(ep);
+    }
+    else if(sp != start){
+        km += OctileHeuristic::cost<int>(start, sp);
+        start = sp;
+    }
+    compute_shortest_path(timeout);
+}
+
+void DStarLite::update_graph(const PlanningGraph& g, const vector<CellRect>& changed){
+    bind(g);
+    if(!initialized) return;
+    int width = layout.get_width(), height = layout.get_height();
+    for(auto rect: changed){
+        // Cells around the region lose or gain the edges into it
+        int x0 = std::max(rect.col-1, 0), x1 = std::min(rect.col+rect.width+1, width);
+        int y0 = std::max(rect.row-1, 0), y1 = std::min(rect.row+rect.height+1, height);
+        for(int row = y0; row < y1; row++){
+            for(int col = x0; col < x1; col++){
+                cell c = {col, row};
+                cell_id id = layout.to_id(c);
+                if(id == goal_id) continue;
+                rhs[id] = is_free(c) ? get_min_successor(c) : UNREACHED;
+                update_vertex(id);
+            }
+        }
+    }
+}
+
+// Greedy descent over the costs to go. Ties go to diagonal moves so the
+// path has as few cells as the A* one.
+pair<vector<cell>, float> DStarLite::reconstruct_path(cell sp, cell ep){
+    auto data = pair<vector<cell>, float>();
+    data.second = std::numeric_limits<float>::infinity();
+    if(!initialized || ep != goal || !tree->is_node_valid(sp)) return data;
+    cell_id start_id = layout.to_id(sp);
+    if(g[start_id] == UNREACHED) return data;
+    size_t max_steps = (size_t)layout.get_width()*layout.get_height();
+    for(cell curr = sp; data.first.size() < max_steps; ){
+        data.first.push_back(curr);
+        if(curr == ep){
+            data.second = g[start_id];
+            return data;
+        }
+        cell next = curr;
+        int best = UNREACHED, best_w = 0;
+        for_each_neighbor<8>(*tree, free_cells, curr, [&](cell n, int w){
+            int cost = add_cost(w, g[layout.to_id(n)]);
+            if(cost < best || (cost == best && cost != UNREACHED && w > best_w)){
+                best = cost;
+                best_w = w;
+                next = n;
+            }
+            return false;
+        });
+        if(best == UNREACHED) break;
+        curr = next;
+    }
+    data.first = vector<cell>();
+    return data;
+}
+
+vector<cell> DStarLite::get_travelled_nodes(){
+    vector<cell> nodes;
+    nodes.reserve(travelled.size());
+    for(auto t: travelled) nodes.push_back(layout.to_cell(t));
+    return nodes;
+}
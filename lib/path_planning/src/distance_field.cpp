@@ -0,0 +1,25 @@
+#include "distance_field.hpp"
+#include "best_first_search.hpp"
+
+void update_distance_field(const PlanningGraph& g, cell source, CellArray<int>& dist){
+    if(!g.is_node_valid(source)) return;
+    const FreeBitmap* free_cells = get_free_cells(g);
+    CellLayout layout(g.get_width(), g.get_height());
+    BucketQueue q(MapData::DIR_WEIGHT[MAX_NEIGHBORS-1]);
+    cell_id source_id = layout.to_id(source);
+    dist[source_id] = 0;
+    q.push(source_id, 0);
+    while(!q.empty()){
+        int key;
+        cell_id curr = q.pop(key);
+        if(key > dist[curr]) continue; // Stale entry
+        for_each_neighbor<8>(g, free_cells, layout.to_cell(curr), [&](cell child, int w){
+            cell_id cp = layout.to_id(child);
+            if(key + w < dist[cp]){
+                dist[cp] = key + w;
+                q.push(cp, key + w);
+            }
+            return false;
+        });
+    }
+}
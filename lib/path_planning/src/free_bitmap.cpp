@@ -0,0 +1,167 @@
+#include "free_bitmap.hpp"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+const uint8_t* FreeBitmap::MASK_LUT = FreeBitmap::build_mask_lut();
+
+// Maps the 9-bit 3x3 window (top | mid << 3 | bot << 6) to a direction mask
+const uint8_t* FreeBitmap::build_mask_lut(){
+    static uint8_t lut[512];
+    for(int idx = 0; idx < 512; idx++){
+        uint8_t mask = 0;
+        for(int d = 0; d < MAX_NEIGHBORS; d++){
+            int bit = (MapData::DIR_DY[d]+1)*3 + (MapData::DIR_DX[d]+1);
+            if((idx >> bit) & 1) mask |= 1 << d;
+        }
+        lut[idx] = mask;
+    }
+    return lut;
+}
+
+FreeBitmap::FreeBitmap(const Map& map) : width(map.px_width), height(map.px_height){
+    // Guard bit on each side plus a spare word so shifted reads stay in the row
+    words_per_row = (width+2+63)/64 + 1;
+    bits.assign((size_t)(height+2)*words_per_row, 0);
+    words = bits.data();
+    for(int row = 0; row < height; row++){
+        const int8_t* cells = map.boundaries[row];
+        uint64_t* w = row_words(row);
+        int col = 0;
+#ifdef __SSE2__
+        // Pack 16 cells at a time into 16 free bits
+        const __m128i open = _mm_set1_epi8(MapData::OPEN_SPACE_INT);
+        for(; col+16 <= width; col += 16){
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cells+col));
+            uint64_t packed = (uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, open));
+            int p = col+1;
+            w[p >> 6] |= packed << (p & 63);
+            if((p & 63) > 48) w[(p >> 6)+1] |= packed >> (64 - (p & 63));
+        }
+#endif
+        for(; col < width; col++){
+            if(cells[col] == MapData::OPEN_SPACE_INT){
+                int p = col+1;
+                w[p >> 6] |= uint64_t(1) << (p & 63);
+            }
+        }
+    }
+}
+
+// Bitmap with every cell blocked
+FreeBitmap::FreeBitmap(int width, int height) : width(width), height(height){
+    words_per_row = (width+2+63)/64 + 1;
+    bits.assign((size_t)(height+2)*words_per_row, 0);
+    words = bits.data();
+}
+
+FreeBitmap FreeBitmap::view(int width, int height, uint64_t* words){
+    FreeBitmap view;
+    view.width = width;
+    view.height = height;
+    view.words_per_row = (width+2+63)/64 + 1;
+    view.words = words;
+    return view;
+}
+
+FreeBitmap::FreeBitmap(const FreeBitmap& other)
+    : width(other.width), height(other.height), words_per_row(other.words_per_row),
+      bits(other.words, other.words + other.get_num_words()), words(bits.data()) {}
+
+// The moved vector keeps its buffer, so words stays valid either way
+FreeBitmap::FreeBitmap(FreeBitmap&& other) noexcept
+    : width(other.width), height(other.height), words_per_row(other.words_per_row),
+      bits(std::move(other.bits)), words(other.words){
+    other.width = other.height = other.words_per_row = 0;
+    other.words = nullptr;
+}
+
+FreeBitmap& FreeBitmap::operator=(FreeBitmap other) noexcept{
+    std::swap(width, other.width);
+    std::swap(height, other.height);
+    std::swap(words_per_row, other.words_per_row);
+    bits.swap(other.bits);
+    std::swap(words, other.words);
+    return *this;
+}
+
+void FreeBitmap::set_free(int col, int row, bool is_free){
+    int p = col+1;
+    uint64_t bit = uint64_t(1) << (p & 63);
+    if(is_free) row_words(row)[p >> 6] |= bit;
+    else row_words(row)[p >> 6] &= ~bit;
+}
+
+// Repacks the cells of rect from the map and returns the change in free cells
+int FreeBitmap::update(const Map& map, CellRect rect){
+    int delta = 0;
+    for(int row = rect.row; row < rect.row+rect.height; row++){
+        const int8_t* cells = map.boundaries[row];
+        for(int col = rect.col; col < rect.col+rect.width; col++){
+            bool now_free = cells[col] == MapData::OPEN_SPACE_INT;
+            delta += (int)now_free - (int)is_free(col, row);
+            set_free(col, row, now_free);
+        }
+    }
+    return delta;
+}
+
+// Guard bits are never free, so every run starts and ends inside the row
+void FreeBitmap::row_runs(int row, std::vector<std::pair<int, int>>& out) const{
+    const uint64_t* w = row_words(row);
+    uint64_t carry = 0;
+    for(int i = 0; i < words_per_row; i++){
+        uint64_t prev = w[i] << 1 | carry;
+        uint64_t edges = (w[i] & ~prev) | (~w[i] & prev);
+        carry = w[i] >> 63;
+        for(; edges; edges &= edges-1){
+            int p = i*64 + __builtin_ctzll(edges);
+            // A rising edge at p starts a run at col p-1, a falling one ends it at p-2
+            if((w[i] >> (p & 63)) & 1) out.push_back({p-1, -1});
+            else out.back().second = p-2;
+        }
+    }
+}
+
+int FreeBitmap::count_free() const{
+    int count = 0;
+    for(size_t i = 0; i < get_num_words(); i++) count += __builtin_popcountll(words[i]);
+    return count;
+}
+
+// Transposes an 8x8 bit matrix stored one row per byte
+static inline uint64_t transpose8(uint64_t x){
+    uint64_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;  x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL; x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL; x = x ^ t ^ (t << 28);
+    return x;
+}
+
+// Bits [64*i + k, 64*i + k + 64) of a padded row
+static inline uint64_t shifted_word(const uint64_t* w, int i, int k){
+    return k == 0 ? w[i] : (w[i] >> k) | (w[i+1] << (64-k));
+}
+
+// Computes the 8-neighbor free mask of every cell in a row, 64 cells at a
+// time. Each direction is a shifted copy of the row above, the row itself or
+// the row below (one bit plane per direction); transposing the planes 8 cells
+// at a time yields one mask byte per cell.
+void FreeBitmap::row_neighbor_masks(int row, uint8_t* out) const{
+    const uint64_t* rows[3] = {row_words(row-1), row_words(row), row_words(row+1)};
+    for(int i = 0; i*64 < width; i++){
+        uint64_t planes[MAX_NEIGHBORS];
+        for(int d = 0; d < MAX_NEIGHBORS; d++){
+            planes[d] = shifted_word(rows[MapData::DIR_DY[d]+1], i, MapData::DIR_DX[d]+1);
+        }
+        int cells = std::min(64, width - i*64);
+        for(int b = 0; b*8 < cells; b++){
+            uint64_t m = 0;
+            for(int d = 0; d < MAX_NEIGHBORS; d++) m |= ((planes[d] >> (8*b)) & 0xFF) << (8*d);
+            m = transpose8(m);
+            int n = std::min(8, cells - b*8);
+            for(int c = 0; c < n; c++) out[i*64 + b*8 + c] = (m >> (8*c)) & 0xFF;
+        }
+    }
+}
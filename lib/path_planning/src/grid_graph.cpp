@@ -0,0 +1,68 @@
+#include "grid_graph.hpp"
+
+GridGraph::GridGraph(const Map& map) : free_cells(map){
+    num_nodes = free_cells.count_free();
+    map_version = map.version;
+}
+
+GridGraph::GridGraph(FreeBitmap free_cells, uint64_t map_version)
+    : free_cells(std::move(free_cells)), map_version(map_version){
+    num_nodes = this->free_cells.count_free();
+}
+
+// Returns false if nothing changed since the last build or update
+bool GridGraph::update(const Map& map){
+    bool same_size = map.px_width == get_width() && map.px_height == get_height();
+    if(same_size && map.version == map_version) return false;
+    vector<CellRect> rects;
+    long dirty_area = 0;
+    bool patch = same_size && MapData::get_dirty_rects(map, map_version, rects);
+    for(auto rect: rects) dirty_area += (long)rect.width*rect.height;
+    // Repacking a large share of the map cell by cell is slower than a rebuild
+    if(!patch || dirty_area*4 >= (long)map.px_width*map.px_height){
+        free_cells = FreeBitmap(map);
+        num_nodes = free_cells.count_free();
+    }
+    else{
+        for(auto rect: rects) num_nodes += free_cells.update(map, rect);
+    }
+    map_version = map.version;
+    return true;
+}
+
+bool GridGraph::is_node_valid(cell node) const{
+    return free_cells.is_free(node.first, node.second);
+}
+
+uint8_t GridGraph::get_neighbor_mask(cell node) const{
+    return free_cells.neighbor_mask(node.first, node.second);
+}
+
+NeighborList GridGraph::get_neighbors(cell parent) const{
+    NeighborList neighbors;
+    if(!is_node_valid(parent)) return neighbors;
+    unsigned mask = get_neighbor_mask(parent);
+    while(mask){
+        int d = __builtin_ctz(mask);
+        mask &= mask-1;
+        neighbors.push_back({cell{parent.first + MapData::DIR_DX[d], parent.second + MapData::DIR_DY[d]},
+                             MapData::DIR_WEIGHT[d]});
+    }
+    return neighbors;
+}
+
+// Nodes are listed in (col,row) order to match Graph::get_nodes
+vector<cell> GridGraph::get_nodes() const{
+    vector<cell> nodes;
+    nodes.reserve(num_nodes);
+    for(int col = 0; col < free_cells.get_width(); col++){
+        for(int row = 0; row < free_cells.get_height(); row++){
+            if(free_cells.is_free(col, row)) nodes.push_back(cell{col, row});
+        }
+    }
+    return nodes;
+}
+
+int GridGraph::get_size() const{
+    return num_nodes;
+}
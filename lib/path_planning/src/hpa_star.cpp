@@ -0,0 +1,297 @@
+#include <queue>
+#include <thread>
+#include <atomic>
+#include "hpa_star.hpp"
+#include "best_first_search.hpp"
+
+using namespace std::chrono;
+
+typedef std::priority_queue<pair<int, int>, vector<pair<int, int>>, std::greater<pair<int, int>>> MinQueue;
+
+HPAStar::HPAStar(const PlanningGraph& g, int cluster_size)
+    : width(g.get_width()), height(g.get_height()), cluster_size(std::max(cluster_size, 2)){
+    clusters_x = (width + this->cluster_size-1)/this->cluster_size;
+    clusters_y = (height + this->cluster_size-1)/this->cluster_size;
+    clusters.resize((size_t)clusters_x*clusters_y);
+    bind(g);
+    vector<int> ids(clusters.size());
+    for(size_t i = 0; i < ids.size(); i++) ids[i] = i;
+    build_clusters(ids);
+    link_clusters();
+}
+
+void HPAStar::bind(const PlanningGraph& g){
+    tree = &g;
+    free_cells = get_free_cells(g);
+    auto grid = dynamic_cast<const GridGraph*>(&g);
+    map_version = grid ? grid->get_map_version() : 0;
+}
+
+bool HPAStar::is_free(cell c) const {
+    return free_cells ? free_cells->is_free(c.first, c.second) : tree->is_node_valid(c);
+}
+
+int HPAStar::get_cluster(cell c) const {
+    return (c.second/cluster_size)*clusters_x + c.first/cluster_size;
+}
+
+// Crossings between neighboring clusters a and b, seen from a. They are
+// always listed from the lower cluster id so both sides agree on them.
+void HPAStar::border_transitions(int a, int b, vector<Transition>& out) const {
+    int lo = std::min(a, b), hi = std::max(a, b);
+    int dx = hi%clusters_x - lo%clusters_x, dy = hi/clusters_x - lo/clusters_x;
+    const int straight = MapData::DIR_WEIGHT[0], diagonal = MapData::DIR_WEIGHT[MAX_NEIGHBORS-1];
+    auto add = [&](cell lo_cell, cell hi_cell, int weight){
+        if(!is_free(lo_cell) || !is_free(hi_cell)) return;
+        if(a == lo) out.push_back({lo_cell, hi_cell, weight});
+        else out.push_back({hi_cell, lo_cell, weight});
+    };
+    int x0 = (hi%clusters_x)*cluster_size, y0 = (hi/clusters_x)*cluster_size;
+    if(dy == 1 && dx != 0){
+        // Diagonal move across the shared corner
+        if(dx == 1) add({x0-1, y0-1}, {x0, y0}, diagonal);
+        else add({x0 + cluster_size, y0-1}, {x0 + cluster_size-1, y0}, diagonal);
+        return;
+    }
+    // Straight border: cell i on the lo side faces cell i on the hi side
+    int length = dx == 1 ? std::min(cluster_size, height - y0) : std::min(cluster_size, width - x0);
+    auto lo_cell = [&](int i){ return dx == 1 ? cell{x0-1, y0+i} : cell{x0+i, y0-1}; };
+    auto hi_cell = [&](int i){ return dx == 1 ? cell{x0, y0+i} : cell{x0+i, y0}; };
+    auto open = [&](int i){ return i >= 0 && i < length && is_free(lo_cell(i)) && is_free(hi_cell(i)); };
+    for(int i = 0; i < length; i++){
+        if(open(i)){
+            int end = i;
+            while(open(end+1)) end++;
+            if(end-i+1 >= LONG_ENTRANCE){
+                add(lo_cell(i), hi_cell(i), straight);
+                add(lo_cell(end), hi_cell(end), straight);
+            }
+            else add(lo_cell((i+end)/2), hi_cell((i+end)/2), straight);
+            i = end;
+        }
+        else if(i+1 < length && !open(i+1)){
+            // Diagonal squeezes between two closed pairs
+            add(lo_cell(i), hi_cell(i+1), diagonal);
+            add(lo_cell(i+1), hi_cell(i), diagonal);
+        }
+    }
+}
+
+void HPAStar::build_cluster(Cluster& c, int id, LocalSearch& search) const {
+    int cx = id%clusters_x, cy = id/clusters_x;
+    c.rect = {cx*cluster_size, cy*cluster_size, std::min(cluster_size, width - cx*cluster_size), std::min(cluster_size, height - cy*cluster_size)};
+    c.transitions.clear();
+    for(int ny = cy-1; ny <= cy+1; ny++){
+        for(int nx = cx-1; nx <= cx+1; nx++){
+            if(nx < 0 || ny < 0 || nx >= clusters_x || ny >= clusters_y || (nx == cx && ny == cy)) continue;
+            border_transitions(id, ny*clusters_x + nx, c.transitions);
+        }
+    }
+    c.nodes.clear();
+    for(auto& t: c.transitions) c.nodes.push_back(t.from);
+    std::sort(c.nodes.begin(), c.nodes.end());
+    c.nodes.erase(std::unique(c.nodes.begin(), c.nodes.end()), c.nodes.end());
+
+    int n = c.nodes.size();
+    c.dist.assign((size_t)n*n, UNREACHED);
+    for(int i = 0; i < n; i++){
+        local_search(c.rect, c.nodes[i], search);
+        for(int j = 0; j < n; j++){
+            auto node = c.nodes[j];
+            c.dist[i*n + j] = search.dist[(node.second - c.rect.row)*c.rect.width + node.first - c.rect.col];
+        }
+    }
+}
+
+// Clusters are independent, so they are built by a pool of workers
+void HPAStar::build_clusters(const vector<int>& ids){
+    std::atomic<size_t> next(0);
+    auto worker = [&](){
+        LocalSearch local;
+        for(size_t i = next++; i < ids.size(); i = next++) build_cluster(clusters[ids[i]], ids[i], local);
+    };
+    int num_threads = std::min<int>(ids.size(), std::max(1u, std::thread::hardware_concurrency()));
+    vector<std::thread> threads;
+    for(int t = 1; t < num_threads; t++) threads.emplace_back(worker);
+    worker();
+    for(auto& t: threads) t.join();
+}
+
+// Numbers the entrances of all clusters and resolves the transitions
+void HPAStar::link_clusters(){
+    int num_nodes = 0;
+    for(auto& c: clusters){
+        c.first_node = num_nodes;
+        num_nodes += c.nodes.size();
+    }
+    node_cluster.resize(num_nodes);
+    for(size_t k = 0; k < clusters.size(); k++){
+        auto& c = clusters[k];
+        std::fill(node_cluster.begin() + c.first_node, node_cluster.begin() + c.first_node + c.nodes.size(), (int)k);
+        c.links.assign(c.nodes.size(), {});
+        for(auto& t: c.transitions){
+            int i = std::lower_bound(c.nodes.begin(), c.nodes.end(), t.from) - c.nodes.begin();
+            auto& other = clusters[get_cluster(t.to)];
+            int j = std::lower_bound(other.nodes.begin(), other.nodes.end(), t.to) - other.nodes.begin();
+            c.links[i].push_back({other.first_node + j, t.weight});
+        }
+    }
+}
+
+int HPAStar::update_graph(const PlanningGraph& g, const vector<CellRect>& changed){
+    bind(g);
+    // A cell next to a border also changes the entrances of the cluster
+    // across it
+    vector<char> dirty(clusters.size(), 0);
+    for(auto rect: changed){
+        int x0 = std::max(rect.col-1, 0), x1 = std::min(rect.col+rect.width, width-1);
+        int y0 = std::max(rect.row-1, 0), y1 = std::min(rect.row+rect.height, height-1);
+        if(x0 > x1 || y0 > y1) continue;
+        for(int cy = y0/cluster_size; cy <= y1/cluster_size; cy++){
+            for(int cx = x0/cluster_size; cx <= x1/cluster_size; cx++) dirty[cy*clusters_x + cx] = 1;
+        }
+    }
+    vector<int> ids;
+    for(size_t i = 0; i < dirty.size(); i++) if(dirty[i]) ids.push_back(i);
+    if(ids.empty()) return 0;
+    build_clusters(ids);
+    link_clusters();
+    return ids.size();
+}
+
+void HPAStar::local_search(const CellRect& rect, cell source, LocalSearch& search, cell target) const {
+    search.dist.assign((size_t)rect.width*rect.height, UNREACHED);
+    search.parent.assign((size_t)rect.width*rect.height, -1);
+    search.queue = BucketQueue(MapData::DIR_WEIGHT[MAX_NEIGHBORS-1]);
+    auto local = [&](cell c){ return (c.second - rect.row)*rect.width + c.first - rect.col; };
+    int target_id = target.first < 0 ? -1 : local(target);
+    search.dist[local(source)] = 0;
+    search.queue.push(cell_id(local(source)), 0);
+    while(!search.queue.empty()){
+        int key;
+        int curr = search.queue.pop(key).v;
+        if(key > search.dist[curr]) continue; // Stale entry
+        if(curr == target_id) return;
+        cell c = {rect.col + curr%rect.width, rect.row + curr/rect.width};
+        for_each_neighbor<8>(*tree, free_cells, c, [&](cell child, int w){
+            if(child.first < rect.col || child.first >= rect.col + rect.width ||
+               child.second < rect.row || child.second >= rect.row + rect.height) return false;
+            int id = local(child);
+            if(key + w < search.dist[id]){
+                search.dist[id] = key + w;
+                search.parent[id] = curr;
+                search.queue.push(cell_id(id), key + w);
+            }
+            return false;
+        });
+    }
+}
+
+void HPAStar::solve(cell sp, cell ep, int timeout){
+    start = sp;
+    goal = ep;
+    goal_reached = false;
+    travelled.clear();
+    int n = node_cluster.size(), start_node = n, goal_node = n+1;
+    abstract_dist.assign(n+2, UNREACHED);
+    abstract_parent.assign(n+2, -1);
+    if(!tree->is_node_valid(sp) || !tree->is_node_valid(ep)) return;
+
+    auto node_cell = [&](int u){
+        auto& c = clusters[node_cluster[u]];
+        return c.nodes[u - c.first_node];
+    };
+    auto h = [&](cell c){ return OctileHeuristic::cost<int>(c, ep); };
+    MinQueue open_set;
+    auto relax = [&](int from, int to, int d, cell c){
+        if(d >= abstract_dist[to]) return;
+        abstract_dist[to] = d;
+        abstract_parent[to] = from;
+        open_set.push({d + h(c), to});
+    };
+
+    // Start and goal are linked to the entrances of their clusters
+    int start_cluster = get_cluster(sp), goal_cluster = get_cluster(ep);
+    auto& first = clusters[start_cluster];
+    auto& last = clusters[goal_cluster];
+    auto local = [](const CellRect& r, cell c){ return (c.second - r.row)*r.width + c.first - r.col; };
+    abstract_dist[start_node] = 0;
+    local_search(first.rect, sp, search);
+    if(start_cluster == goal_cluster && search.dist[local(first.rect, ep)] != UNREACHED){
+        relax(start_node, goal_node, search.dist[local(first.rect, ep)], ep);
+    }
+    for(size_t i = 0; i < first.nodes.size(); i++){
+        int d = search.dist[local(first.rect, first.nodes[i])];
+        if(d != UNREACHED) relax(start_node, first.first_node + i, d, first.nodes[i]);
+    }
+    vector<int> to_goal(last.nodes.size());
+    local_search(last.rect, ep, search);
+    for(size_t i = 0; i < last.nodes.size(); i++) to_goal[i] = search.dist[local(last.rect, last.nodes[i])];
+
+    int expanded = 0;
+    auto start_time = high_resolution_clock::now();
+    while(!open_set.empty()){
+        auto [key, u] = open_set.top();
+        open_set.pop();
+        if(u == goal_node){
+            goal_reached = true;
+            break;
+        }
+        cell uc = node_cell(u);
+        int d = abstract_dist[u];
+        if(key > d + h(uc)) continue; // Stale entry
+        if(++expanded % TIMEOUT_CHECK_INTERVAL == 0){
+            auto now = high_resolution_clock::now();
+            if(duration_cast<milliseconds>(now-start_time).count() >= timeout) break;
+        }
+        travelled.push_back(uc);
+        auto& c = clusters[node_cluster[u]];
+        int i = u - c.first_node, m = c.nodes.size();
+        for(int j = 0; j < m; j++){
+            int w = c.dist[i*m + j];
+            if(j != i && w != UNREACHED) relax(u, c.first_node + j, d + w, c.nodes[j]);
+        }
+        for(auto [v, w]: c.links[i]) relax(u, v, d + w, node_cell(v));
+        if(node_cluster[u] == goal_cluster && to_goal[i] != UNREACHED) relax(u, goal_node, d + to_goal[i], ep);
+    }
+}
+
+// Steps between entrances of one cluster are refined by a search inside
+// it; transitions are single moves
+pair<vector<cell>, float> HPAStar::reconstruct_path(cell sp, cell ep){
+    auto data = pair<vector<cell>, float>();
+    data.second = std::numeric_limits<float>::infinity();
+    if(!goal_reached) return data;
+    int n = node_cluster.size();
+    vector<cell> waypoints = {ep};
+    for(int u = abstract_parent[n+1]; u != n; u = abstract_parent[u]){
+        auto& c = clusters[node_cluster[u]];
+        waypoints.push_back(c.nodes[u - c.first_node]);
+    }
+    waypoints.push_back(sp);
+    std::reverse(waypoints.begin(), waypoints.end());
+
+    data.first.push_back(sp);
+    vector<cell> segment;
+    for(size_t k = 1; k < waypoints.size(); k++){
+        cell a = waypoints[k-1], b = waypoints[k];
+        if(a == b) continue;
+        if(get_cluster(a) != get_cluster(b)){
+            data.first.push_back(b);
+            continue;
+        }
+        auto& rect = clusters[get_cluster(a)].rect;
+        local_search(rect, a, search, b);
+        segment.clear();
+        for(int id = (b.second - rect.row)*rect.width + b.first - rect.col; search.parent[id] >= 0; id = search.parent[id]){
+            segment.push_back({rect.col + id%rect.width, rect.row + id/rect.width});
+        }
+        data.first.insert(data.first.end(), segment.rbegin(), segment.rend());
+    }
+    data.second = abstract_dist[n+1];
+    return data;
+}
+
+vector<cell> HPAStar::get_travelled_nodes(){
+    return travelled;
+}
@@ -0,0 +1,204 @@
+#include <mutex>
+#include "jps.hpp"
+#include "best_first_search.hpp"
+
+using namespace std::chrono;
+
+// MapData::DIR_* index of the step (dx,dy), indexed by (dy+1)*3 + (dx+1)
+static const int DIR_INDEX[9] = {4, 0, 5, 2, -1, 3, 6, 1, 7};
+
+static int dir_index(int dx, int dy){
+    return DIR_INDEX[(dy+1)*3 + (dx+1)];
+}
+
+static int sign(int v){
+    return (v > 0) - (v < 0);
+}
+
+// Diagonal moves may cut corners (see FreeBitmap::neighbor_mask), so a
+// neighbor is forced when the cell beside the move is blocked and the cell
+// diagonally ahead of it is free
+static bool has_forced_neighbor(const FreeBitmap& f, int col, int row, int dx, int dy){
+    if(dx != 0 && dy != 0){
+        return (!f.is_free(col-dx, row) && f.is_free(col-dx, row+dy)) ||
+               (!f.is_free(col, row-dy) && f.is_free(col+dx, row-dy));
+    }
+    for(int s = -1; s <= 1; s += 2){
+        int px = s*dy, py = s*dx;
+        if(!f.is_free(col+px, row+py) && f.is_free(col+px+dx, row+py+dy)) return true;
+    }
+    return false;
+}
+
+// Each direction is swept from the far side of the map so the cell one step
+// ahead is already done. Straight directions (0-3) come before diagonal
+// ones, which stop wherever a straight jump finds a jump point.
+JumpTable::JumpTable(const FreeBitmap& free_cells)
+    : width(free_cells.get_width()), height(free_cells.get_height()){
+    dists.assign((size_t)width*height*MAX_NEIGHBORS, 0);
+    for(int d = 0; d < MAX_NEIGHBORS; d++){
+        int dx = MapData::DIR_DX[d], dy = MapData::DIR_DY[d];
+        bool diagonal = dx != 0 && dy != 0;
+        for(int i = 0; i < height; i++){
+            int row = dy > 0 ? height-1-i : i;
+            for(int j = 0; j < width; j++){
+                int col = dx > 0 ? width-1-j : j;
+                int nc = col+dx, nr = row+dy;
+                int16_t& v = at(col, row, d);
+                if(!free_cells.is_free(nc, nr)) v = 0;
+                else if(has_forced_neighbor(free_cells, nc, nr, dx, dy) ||
+                        (diagonal && (get(nc, nr, dir_index(dx, 0)) > 0 || get(nc, nr, dir_index(0, dy)) > 0))) v = 1;
+                else{
+                    int next = get(nc, nr, d);
+                    int steps = next > 0 ? next+1 : next-1;
+                    // Past MAX_JUMP the next cell becomes a jump point
+                    v = std::abs(steps) > MAX_JUMP ? 1 : steps;
+                }
+            }
+        }
+    }
+}
+
+// Last table built for a GridGraph. Every map has its own version and
+// MapData::mark_dirty gives every edit a new one, so the version alone tells
+// whether the table still fits.
+shared_ptr<const JumpTable> JPS::get_jump_table(const GridGraph& g){
+    static std::mutex cache_mutex;
+    static shared_ptr<const JumpTable> cached;
+    static uint64_t cached_version = 0;
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    uint64_t version = g.get_map_version();
+    if(cached && version == cached_version && cached->get_width() == g.get_width() &&
+       cached->get_height() == g.get_height()) return cached;
+    cached = make_shared<const JumpTable>(g.get_free_bitmap());
+    cached_version = version;
+    return cached;
+}
+
+JPS::JPS(const PlanningGraph& g) : tree(g){
+    int width = tree.get_width(), height = tree.get_height();
+    auto grid = dynamic_cast<const GridGraph*>(&g);
+    if(grid){
+        free_cells = &grid->get_free_bitmap();
+        jumps = JPS::get_jump_table(*grid);
+    }
+    else{
+        own_cells = FreeBitmap(width, height);
+        for(auto node: tree.get_nodes()) own_cells.set_free(node.first, node.second, true);
+        free_cells = &own_cells;
+        jumps = make_shared<const JumpTable>(own_cells);
+    }
+    layout = CellLayout(width, height);
+    dist = CellArray<int>(width, height, UNREACHED);
+    parent = CellArray<cell_id>(width, height, cell_id());
+    state = CellArray<uint8_t>(width, height, UNSEEN);
+    open_set = IndexedHeap<>(width, height);
+}
+
+// Directions to search from a jump point as a MapData::DIR_* bit mask: the
+// natural neighbors of the move that reached it plus its forced neighbors
+unsigned JPS::get_directions(cell c) const{
+    cell_id p = parent[c];
+    if(!p.is_valid()) return 0xFF;
+    cell pc = layout.to_cell(p);
+    int dx = sign(c.first - pc.first), dy = sign(c.second - pc.second);
+    int col = c.first, row = c.second;
+    unsigned dirs = 1 << dir_index(dx, dy);
+    if(dx != 0 && dy != 0){
+        dirs |= 1 << dir_index(dx, 0) | 1 << dir_index(0, dy);
+        if(!is_free(col-dx, row) && is_free(col-dx, row+dy)) dirs |= 1 << dir_index(-dx, dy);
+        if(!is_free(col, row-dy) && is_free(col+dx, row-dy)) dirs |= 1 << dir_index(dx, -dy);
+    }
+    else{
+        for(int s = -1; s <= 1; s += 2){
+            int px = s*dy, py = s*dx;
+            if(!is_free(col+px, row+py) && is_free(col+px+dx, row+py+dy)) dirs |= 1 << dir_index(px+dx, py+dy);
+        }
+    }
+    return dirs;
+}
+
+void JPS::add_successor(cell_id curr, cell next, int cost, cell ep){
+    cell_id id = layout.to_id(next);
+    int new_dist = dist[curr] + cost;
+    if(new_dist >= dist[id]) return;
+    if(state[id] == UNSEEN) travelled.push_back(id);
+    dist[id] = new_dist;
+    parent[id] = curr;
+    state[id] = OPEN;
+    open_set.push(id, new_dist + OctileHeuristic::cost<int>(next, ep), new_dist);
+}
+
+void JPS::solve(cell sp, cell ep, int timeout){
+    if(!tree.is_node_valid(sp)) return;
+    cell_id start_id = layout.to_id(sp), goal_id = layout.to_id(ep);
+    dist[start_id] = 0;
+    state[start_id] = OPEN;
+    open_set.push(start_id, OctileHeuristic::cost<int>(sp, ep), 0);
+    int expanded = 0;
+    auto start = high_resolution_clock::now();
+    while(!open_set.empty()){
+        if(++expanded % TIMEOUT_CHECK_INTERVAL == 0){
+            auto now = high_resolution_clock::now();
+            if(duration_cast<milliseconds>(now-start).count() >= timeout) break;
+        }
+        cell_id curr = open_set.pop();
+        state[curr] = CLOSED;
+        if(curr == goal_id){
+            goal_reached = true;
+            break;
+        }
+        cell c = layout.to_cell(curr);
+        int gx = ep.first - c.first, gy = ep.second - c.second;
+        unsigned dirs = get_directions(c);
+        while(dirs){
+            int d = __builtin_ctz(dirs);
+            dirs &= dirs-1;
+            int dx = MapData::DIR_DX[d], dy = MapData::DIR_DY[d];
+            int jump = jumps->get(c.first, c.second, d);
+            int steps = jump > 0 ? jump : -jump;
+            // The goal (or the cell of the diagonal run level with it) is a
+            // jump point if it comes before the next jump point or wall
+            if(dx == 0 || dy == 0){
+                bool on_ray = dx == 0 ? gx == 0 && sign(gy) == dy : gy == 0 && sign(gx) == dx;
+                int goal_steps = std::abs(gx) + std::abs(gy);
+                if(on_ray && goal_steps <= steps){
+                    add_successor(curr, ep, goal_steps*MapData::DIR_WEIGHT[d], ep);
+                    continue;
+                }
+            }
+            else if(sign(gx) == dx && sign(gy) == dy){
+                int diff = std::min(std::abs(gx), std::abs(gy));
+                if(diff <= steps){
+                    add_successor(curr, cell{c.first + diff*dx, c.second + diff*dy}, diff*MapData::DIR_WEIGHT[d], ep);
+                    continue;
+                }
+            }
+            if(jump > 0) add_successor(curr, cell{c.first + jump*dx, c.second + jump*dy}, jump*MapData::DIR_WEIGHT[d], ep);
+        }
+    }
+}
+
+// Fills in the straight and diagonal runs between consecutive jump points
+pair<vector<cell>, float> JPS::reconstruct_path(cell sp, cell ep){
+    auto data = pair<vector<cell>, float>();
+    for(cell_id curr = layout.to_id(ep); curr.is_valid(); curr = parent[curr]){
+        cell c = layout.to_cell(curr);
+        data.first.push_back(c);
+        if(!parent[curr].is_valid()) break;
+        cell p = layout.to_cell(parent[curr]);
+        int dx = sign(p.first - c.first), dy = sign(p.second - c.second);
+        for(cell s = {c.first+dx, c.second+dy}; s != p; s = {s.first+dx, s.second+dy}) data.first.push_back(s);
+    }
+    std::reverse(data.first.begin(), data.first.end());
+    if(data.first[0] != sp) data.first = vector<cell>();
+    data.second = dist[ep] == UNREACHED ? std::numeric_limits<float>::infinity() : dist[ep];
+    return data;
+}
+
+vector<cell> JPS::get_travelled_nodes(){
+    vector<cell> nodes;
+    nodes.reserve(travelled.size());
+    for(auto t: travelled) nodes.push_back(layout.to_cell(t));
+    return nodes;
+}
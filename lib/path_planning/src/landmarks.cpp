@@ -0,0 +1,117 @@
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <cstring>
+#include "landmarks.hpp"
+#include "distance_field.hpp"
+
+// Layout of a serialized table: header, landmark cells, distances
+struct LandmarkHeader {
+    int32_t width, height, num_landmarks, reserved;
+};
+
+LandmarkTable::LandmarkTable(const PlanningGraph& g, int num_landmarks)
+    : width(g.get_width()), height(g.get_height()){
+    auto free_cells = get_free_cells(g);
+    if(free_cells) words.assign(free_cells->get_words(), free_cells->get_words() + free_cells->get_num_words());
+
+    // Farthest-point selection: the first landmark is the cell farthest from
+    // an arbitrary free cell, every next one the cell farthest from all
+    // landmarks so far
+    vector<cell> nodes = g.get_nodes();
+    if(nodes.empty()) return;
+    CellLayout layout(width, height);
+    CellArray<int> nearest(width, height, UNREACHED_DIST);
+    update_distance_field(g, nodes[nodes.size()/2], nearest);
+    for(int i = 0; i < num_landmarks; i++){
+        cell farthest = {-1, -1};
+        int farthest_dist = -1;
+        for(auto n: nodes){
+            int d = nearest[n];
+            if(d != UNREACHED_DIST && d > farthest_dist){
+                farthest_dist = d;
+                farthest = n;
+            }
+        }
+        if(farthest_dist <= 0) break;
+        if(i == 0) nearest.fill(UNREACHED_DIST);
+        landmarks.push_back(farthest);
+        update_distance_field(g, farthest, nearest);
+    }
+    this->num_landmarks = landmarks.size();
+
+    // One Dijkstra per landmark, spread over the available cores
+    dists.assign((size_t)width*height*this->num_landmarks, UNREACHED);
+    std::atomic<int> next(0);
+    auto worker = [&](){
+        CellArray<int> field(width, height, UNREACHED_DIST);
+        for(int i = next++; i < this->num_landmarks; i = next++){
+            field.fill(UNREACHED_DIST);
+            update_distance_field(g, landmarks[i], field);
+            for(int row = 0; row < height; row++){
+                for(int col = 0; col < width; col++){
+                    int d = field[cell{col, row}];
+                    if(d == UNREACHED_DIST) continue;
+                    dists[((size_t)row*width + col)*this->num_landmarks + i] = std::min(d, (int)UNREACHED-1);
+                }
+            }
+        }
+    };
+    int num_threads = std::min<int>(this->num_landmarks, std::max(1u, std::thread::hardware_concurrency()));
+    vector<std::thread> threads;
+    for(int t = 1; t < num_threads; t++) threads.emplace_back(worker);
+    worker();
+    for(auto& t: threads) t.join();
+}
+
+vector<char> LandmarkTable::serialize() const {
+    LandmarkHeader header = {width, height, num_landmarks, 0};
+    vector<int32_t> cells;
+    for(auto l: landmarks){
+        cells.push_back(l.first);
+        cells.push_back(l.second);
+    }
+    vector<char> data(sizeof(header) + cells.size()*sizeof(int32_t) + dists.size()*sizeof(uint16_t));
+    char* p = data.data();
+    std::memcpy(p, &header, sizeof(header));
+    std::memcpy(p += sizeof(header), cells.data(), cells.size()*sizeof(int32_t));
+    std::memcpy(p + cells.size()*sizeof(int32_t), dists.data(), dists.size()*sizeof(uint16_t));
+    return data;
+}
+
+shared_ptr<LandmarkTable> LandmarkTable::deserialize(const void* data, size_t size, const PlanningGraph& g){
+    if(!data || size < sizeof(LandmarkHeader)) return nullptr;
+    LandmarkHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    size_t num_cells = (size_t)header.width*header.height;
+    if(header.width != g.get_width() || header.height != g.get_height() || header.num_landmarks < 0 ||
+       size != sizeof(header) + (size_t)header.num_landmarks*(2*sizeof(int32_t) + num_cells*sizeof(uint16_t))) return nullptr;
+    auto table = shared_ptr<LandmarkTable>(new LandmarkTable());
+    table->width = header.width;
+    table->height = header.height;
+    table->num_landmarks = header.num_landmarks;
+    auto p = static_cast<const char*>(data) + sizeof(header);
+    vector<int32_t> cells(2*header.num_landmarks);
+    std::memcpy(cells.data(), p, cells.size()*sizeof(int32_t));
+    for(int i = 0; i < header.num_landmarks; i++) table->landmarks.push_back(cell{cells[2*i], cells[2*i+1]});
+    table->dists.resize(num_cells*header.num_landmarks);
+    std::memcpy(table->dists.data(), p + cells.size()*sizeof(int32_t), table->dists.size()*sizeof(uint16_t));
+    auto free_cells = get_free_cells(g);
+    if(free_cells) table->words.assign(free_cells->get_words(), free_cells->get_words() + free_cells->get_num_words());
+    return table;
+}
+
+shared_ptr<const LandmarkTable> LandmarkTable::get_landmark_table(const GridGraph& g, int num_landmarks){
+    static std::mutex cache_mutex;
+    static shared_ptr<const LandmarkTable> cached;
+    static uint64_t cached_version = 0;
+    static int cached_landmarks = 0;
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    uint64_t version = g.get_map_version();
+    if(cached && version == cached_version && num_landmarks == cached_landmarks &&
+       cached->matches(g.get_free_bitmap())) return cached;
+    cached = make_shared<const LandmarkTable>(g, num_landmarks);
+    cached_version = version;
+    cached_landmarks = num_landmarks;
+    return cached;
+}
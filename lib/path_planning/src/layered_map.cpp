@@ -0,0 +1,48 @@
+#include "layered_map.hpp"
+
+int LayeredMap::add_layer(){
+    layers.emplace_back();
+    return layers.size()-1;
+}
+
+void LayeredMap::clear_layer(int layer){
+    layers[layer].clear();
+}
+
+void LayeredMap::add_cells(int layer, const vector<cell>& cells, int8_t val){
+    for(auto c: cells) layers[layer].push_back(OverlayCell{c.first, c.second, val});
+}
+
+// Square of size x size cells centered on pt, clipped to the map (as drawn by
+// MapData::inflate_point)
+void LayeredMap::add_point(int layer, cell pt, int8_t val, int size){
+    CellRect rect = MapData::point_rect(*base, pt, size);
+    for(int row = rect.row; row < rect.row+rect.height; row++){
+        for(int col = rect.col; col < rect.col+rect.width; col++){
+            layers[layer].push_back(OverlayCell{col, row, val});
+        }
+    }
+}
+
+void LayeredMap::add_path(int layer, const vector<cell>& path, int8_t val, int size){
+    for(auto p: path) add_point(layer, p, val, size);
+}
+
+// Composed value of a single cell (last overlay cell covering it wins)
+int8_t LayeredMap::value_at(int col, int row) const{
+    for(auto layer = layers.rbegin(); layer != layers.rend(); layer++){
+        for(auto oc = layer->rbegin(); oc != layer->rend(); oc++){
+            if(oc->col == col && oc->row == row) return oc->val;
+        }
+    }
+    return base->boundaries[row][col];
+}
+
+// Dense copy of the composed map, for callers that need a plain Map
+Map LayeredMap::compose() const{
+    Map map = MapData::copy_map(*base);
+    for(auto& layer: layers){
+        for(auto& oc: layer) map.boundaries[oc.row][oc.col] = oc.val;
+    }
+    return map;
+}
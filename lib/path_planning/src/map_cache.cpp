@@ -0,0 +1,268 @@
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "map_cache.hpp"
+
+static const char CACHE_MAGIC[8] = {'R', 'P', 'P', 'C', 'A', 'C', 'H', 'E'};
+static const size_t SECTION_ALIGN = 64;
+
+static size_t align_up(size_t v){
+    return (v + SECTION_ALIGN-1) & ~(SECTION_ALIGN-1);
+}
+
+MapCache::~MapCache(){
+    close();
+}
+
+string MapCache::get_cache_path(string yaml_path, int inflate_size){
+    std::filesystem::path p = yaml_path;
+    string name = p.stem().string() + "_inflate" + std::to_string(inflate_size) + ".rppc";
+    return (p.parent_path() / name).string();
+}
+
+// 64-bit FNV-1a over 8-byte words of the file (0 if it can not be read)
+uint64_t MapCache::hash_file(string path){
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) return 0;
+    uint64_t h = 0xcbf29ce484222325ULL;
+    vector<uint64_t> buf(1 << 16);
+    ssize_t n;
+    while((n = ::read(fd, buf.data(), buf.size()*sizeof(uint64_t))) > 0){
+        size_t words = (n + 7)/8;
+        if(n % 8) std::memset(reinterpret_cast<char*>(buf.data()) + n, 0, words*8 - n);
+        for(size_t i = 0; i < words; i++) h = (h ^ buf[i]) * 0x100000001b3ULL;
+        h = (h ^ (uint64_t)n) * 0x100000001b3ULL;
+    }
+    ::close(fd);
+    return h;
+}
+
+bool MapCache::stat_file(string path, uint64_t* size, int64_t* mtime){
+    struct stat st;
+    if(::stat(path.c_str(), &st) != 0) return false;
+    *size = st.st_size;
+    *mtime = (int64_t)st.st_mtim.tv_sec*1000000000 + st.st_mtim.tv_nsec;
+    return true;
+}
+
+bool MapCache::write(string yaml_path, int inflate_size, const Map& map, const vector<CacheBlob>& extra){
+    FreeBitmap free_cells(map);
+    vector<int8_t> grid((size_t)map.px_width*map.px_height);
+    for(int row = 0; row < map.px_height; row++){
+        std::memcpy(grid.data() + (size_t)row*map.px_width, map.boundaries[row], map.px_width);
+    }
+    vector<CacheBlob> sections = {
+        {CACHE_GRID, grid.data(), grid.size()},
+        {CACHE_FREE_BITMAP, free_cells.get_words(), free_cells.get_num_words()*sizeof(uint64_t)}
+    };
+    sections.insert(sections.end(), extra.begin(), extra.end());
+
+    CacheHeader header = {};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.format_version = FORMAT_VERSION;
+    header.inflate_size = inflate_size;
+    string pgm_path = MapData::get_image_path(yaml_path);
+    header.pgm_hash = MapCache::hash_file(pgm_path);
+    MapCache::stat_file(pgm_path, &header.pgm_size, &header.pgm_mtime);
+    header.yaml_hash = MapCache::hash_file(yaml_path);
+    header.width = map.px_width;
+    header.height = map.px_height;
+    header.resolution = map.resolution;
+    header.m_width = map.m_width;
+    header.m_height = map.m_height;
+    header.num_sections = sections.size();
+
+    vector<CacheSectionEntry> table(sections.size());
+    size_t offset = align_up(sizeof(CacheHeader) + table.size()*sizeof(CacheSectionEntry));
+    for(size_t i = 0; i < sections.size(); i++){
+        table[i] = CacheSectionEntry{sections[i].type, 0, offset, sections[i].size};
+        offset = align_up(offset + sections[i].size);
+    }
+
+    // Write to a temporary file and rename so readers never see a partial cache
+    string path = MapCache::get_cache_path(yaml_path, inflate_size);
+    string tmp_path = path + ".tmp";
+    fstream out(tmp_path, ios::out | ios::binary | ios::trunc);
+    if(!out.is_open()) return false;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(table.data()), table.size()*sizeof(CacheSectionEntry));
+    for(size_t i = 0; i < sections.size(); i++){
+        size_t pos = out.tellp();
+        std::string pad(table[i].offset - pos, '\0');
+        out.write(pad.data(), pad.size());
+        out.write(reinterpret_cast<const char*>(sections[i].data), sections[i].size);
+    }
+    out.close();
+    if(!out) return false;
+    return std::rename(tmp_path.c_str(), path.c_str()) == 0;
+}
+
+bool MapCache::open(string yaml_path, int inflate_size){
+    close();
+    string path = MapCache::get_cache_path(yaml_path, inflate_size);
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) return false;
+    struct stat st;
+    if(fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(CacheHeader)){
+        ::close(fd);
+        return false;
+    }
+    // Private mapping so edits to a cached map never reach the file
+    length = st.st_size;
+    data = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(data == MAP_FAILED){
+        data = nullptr;
+        return false;
+    }
+
+    auto h = reinterpret_cast<const CacheHeader*>(data);
+    size_t table_end = sizeof(CacheHeader) + (size_t)h->num_sections*sizeof(CacheSectionEntry);
+    bool valid = std::memcmp(h->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 &&
+                 h->format_version == FORMAT_VERSION && h->inflate_size == inflate_size &&
+                 table_end <= length;
+    if(valid){
+        auto table = reinterpret_cast<const CacheSectionEntry*>(h+1);
+        for(uint32_t i = 0; i < h->num_sections; i++){
+            if(table[i].offset > length || table[i].size > length - table[i].offset) valid = false;
+        }
+    }
+    // The yaml is small, so it is always hashed; the PGM only when it was touched
+    if(valid) valid = h->yaml_hash == MapCache::hash_file(yaml_path);
+    if(valid){
+        string pgm_path = MapData::get_image_path(yaml_path);
+        uint64_t pgm_size = 0;
+        int64_t pgm_mtime = 0;
+        bool same_file = MapCache::stat_file(pgm_path, &pgm_size, &pgm_mtime) &&
+                         pgm_size == h->pgm_size && pgm_mtime == h->pgm_mtime;
+        if(!same_file) valid = h->pgm_hash == MapCache::hash_file(pgm_path);
+    }
+    if(!valid){
+        close();
+        return false;
+    }
+    header = h;
+    this->yaml_path = yaml_path;
+    this->inflate_size = inflate_size;
+    return true;
+}
+
+void MapCache::close(){
+    if(data) munmap(data, length);
+    data = nullptr;
+    length = 0;
+    header = nullptr;
+    map_version = 0;
+    added.clear();
+}
+
+const void* MapCache::get_section(uint32_t type, size_t* size) const{
+    if(!header) return nullptr;
+    auto table = reinterpret_cast<const CacheSectionEntry*>(header+1);
+    for(uint32_t i = 0; i < header->num_sections; i++){
+        if(table[i].type != type) continue;
+        if(size) *size = table[i].size;
+        return static_cast<const char*>(data) + table[i].offset;
+    }
+    return nullptr;
+}
+
+// The returned map wraps the mapped grid when the cache is used, so the
+// cache has to stay open while the map is in use
+Map MapCache::load_map(string yaml_path, int inflate_size){
+    size_t grid_size = 0;
+    if(open(yaml_path, inflate_size)){
+        auto grid = static_cast<const int8_t*>(get_section(CACHE_GRID, &grid_size));
+        if(grid && grid_size == (size_t)header->width*header->height){
+            Map map;
+            map.px_width = header->width;
+            map.px_height = header->height;
+            map.resolution = header->resolution;
+            map.m_width = header->m_width;
+            map.m_height = header->m_height;
+            map.boundaries = OccupancyGrid(const_cast<int8_t*>(grid), map.px_width, map.px_height);
+            map_version = map.version;
+            return map;
+        }
+        close();
+    }
+    Map map = MapData::get_map(yaml_path);
+    map.boundaries = MapData::inflate_boundaries(map, inflate_size);
+    if(!map.boundaries.empty() && !MapCache::write(yaml_path, inflate_size, map)){
+        cout << "Could not write map cache: " << MapCache::get_cache_path(yaml_path, inflate_size) << endl;
+    }
+    else if(!map.boundaries.empty() && open(yaml_path, inflate_size)) map_version = map.version;
+    return map;
+}
+
+// The graph views the mapped bitmap, so like the map it needs the cache open
+GridGraph MapCache::get_graph(const Map& map) const{
+    size_t size = 0;
+    auto words = static_cast<uint64_t*>(const_cast<void*>(get_section(CACHE_FREE_BITMAP, &size)));
+    size_t words_per_row = (map.px_width+2+63)/64 + 1;
+    if(words && map.version == map_version && header->width == map.px_width && header->height == map.px_height &&
+       size == (size_t)(map.px_height+2)*words_per_row*sizeof(uint64_t)){
+        return GridGraph(FreeBitmap::view(map.px_width, map.px_height, words), map.version);
+    }
+    return GridGraph(map);
+}
+
+shared_ptr<const LandmarkTable> MapCache::get_landmarks(const Map& map, const GridGraph& g, int num_landmarks){
+    bool unchanged = header && map.version == map_version;
+    if(unchanged){
+        size_t size = 0;
+        const void* section = get_section(CACHE_LANDMARKS, &size);
+        auto table = LandmarkTable::deserialize(section, size, g);
+        if(table && (int)table->get_landmarks().size() == num_landmarks) return table;
+    }
+    auto table = make_shared<const LandmarkTable>(g, num_landmarks);
+    if(unchanged) add_section(map, CACHE_LANDMARKS, table->serialize());
+    return table;
+}
+
+shared_ptr<const ContractionHierarchy> MapCache::get_contraction_hierarchy(const Map& map, const GridGraph& g){
+    bool unchanged = header && map.version == map_version;
+    if(unchanged){
+        size_t size = 0;
+        const void* section = get_section(CACHE_CONTRACTION_HIERARCHY, &size);
+        auto ch = ContractionHierarchy::deserialize(section, size, g);
+        if(ch) return ch;
+    }
+    auto ch = make_shared<const ContractionHierarchy>(g);
+    if(unchanged) add_section(map, CACHE_CONTRACTION_HIERARCHY, ch->serialize());
+    return ch;
+}
+
+shared_ptr<const ComponentLabels> MapCache::get_components(const Map& map, const GridGraph& g){
+    bool unchanged = header && map.version == map_version;
+    if(unchanged){
+        size_t size = 0;
+        const void* section = get_section(CACHE_COMPONENTS, &size);
+        auto components = ComponentLabels::deserialize(section, size, g);
+        if(components) return components;
+    }
+    auto components = make_shared<const ComponentLabels>(g);
+    if(unchanged) add_section(map, CACHE_COMPONENTS, components->serialize());
+    return components;
+}
+
+// Rewrites the cache from the map as loaded, keeping the other precomputed
+// sections. The open mapping stays valid but holds the file as opened, so
+// sections added since are kept in memory as well.
+void MapCache::add_section(const Map& map, uint32_t type, vector<char> section){
+    added[type] = std::move(section);
+    vector<CacheBlob> extra;
+    for(auto& s: added) extra.push_back({s.first, s.second.data(), s.second.size()});
+    auto table = reinterpret_cast<const CacheSectionEntry*>(header+1);
+    for(uint32_t i = 0; i < header->num_sections; i++){
+        if(table[i].type == CACHE_GRID || table[i].type == CACHE_FREE_BITMAP || added.count(table[i].type)) continue;
+        extra.push_back({table[i].type, static_cast<const char*>(data) + table[i].offset, table[i].size});
+    }
+    string path = yaml_path;
+    if(!MapCache::write(path, inflate_size, map, extra)){
+        cout << "Could not write map cache: " << MapCache::get_cache_path(path, inflate_size) << endl;
+    }
+}
@@ -1,4 +1,59 @@
+#include <atomic>
+
 #include "map_data.hpp"
+#include "free_bitmap.hpp"
+#include "layered_map.hpp"
+
+Graph::Graph(int width, int height) : width(width), height(height){
+    offsets.assign((size_t)width*height+1, 0);
+    nodes.assign((size_t)width*height, false);
+}
+
+vector<cell> Graph::get_edges_without_weights(cell parent) const{
+    vector<cell> temp;
+    for(auto child: get_edges(parent)) temp.push_back(child.first);
+    return temp;
+}
+
+// Nodes are listed in (col,row) order to match the ordering of cell
+vector<cell> Graph::get_nodes() const{
+    vector<cell> node_list;
+    node_list.reserve(num_nodes);
+    for(int col = 0; col < width; col++){
+        for(int row = 0; row < height; row++){
+            if(nodes[row*width + col]) node_list.push_back(cell{col, row});
+        }
+    }
+    return node_list;
+}
+
+void Graph::open_node(int id){
+    if(id < last_id) throw std::logic_error("Graph nodes must be added in row-major order");
+    for(int k = last_id+1; k <= id; k++) offsets[k] = targets.size();
+    last_id = id;
+    if(!nodes[id]){
+        nodes[id] = true;
+        num_nodes++;
+    }
+}
+
+void Graph::add_node(cell node){
+    if(!in_bounds(node)) throw std::out_of_range("Node is outside of graph bounds");
+    open_node(to_id(node));
+}
+
+void Graph::add_edge(cell parent, cell child, int weight){
+    if(!in_bounds(parent) || !in_bounds(child)) throw std::out_of_range("Edge is outside of graph bounds");
+    open_node(to_id(parent));
+    if(targets.size() - offsets[last_id] >= MAX_NEIGHBORS) throw std::logic_error("Node exceeds maximum number of neighbors");
+    targets.push_back(to_id(child));
+    weights.push_back(weight);
+}
+
+void Graph::reserve_edges(size_t num_edges){
+    targets.reserve(num_edges);
+    weights.reserve(num_edges);
+}
 
 Map MapData::parse_pgm(string mp){
     Map data;
@@ -19,8 +74,7 @@ Map MapData::parse_pgm(string mp){
         getline(map_input, line);
         highest_val = std::stoi(line);
         getline(map_input, line);
-        int** temp = new int*[height];
-        for(int k = 0; k < height; k++) temp[k] = new int[width];
+        OccupancyGrid temp(width, height);
         int i = 0;
         int j = 0;
         for(char px : line) {
@@ -36,7 +90,7 @@ Map MapData::parse_pgm(string mp){
         }
         data.px_height = height;
         data.px_width = width;
-        data.boundaries = temp;
+        data.boundaries = std::move(temp);
     }
     return data;
 }
@@ -111,45 +165,68 @@ Map MapData::get_map(string yp){
     }
 }
 
-int** MapData::copy_boundaries(Map map){
-    int** new_boundaries = new int*[map.px_height];
-    for(int k = 0; k < map.px_height; k++) new_boundaries[k] = new int[map.px_width];
-    for(int row = 0; row < map.px_height; row++){
-        for(int col = 0; col < map.px_width; col++){
-            new_boundaries[row][col] = map.boundaries[row][col];
+// Path of the PGM image referenced by a map yaml (empty if not found)
+string MapData::get_image_path(string yp){
+    fstream yaml_file;
+    yaml_file.open(yp, ios::in);
+    string line, word;
+    while(getline(yaml_file, line)){
+        stringstream ss(line);
+        getline(ss, word, ':');
+        if(word == "image"){
+            getline(ss, word, ':');
+            string image = word[0] == ' ' ? word.substr(1, word.size()-1) : word;
+            return (std::filesystem::path(yp).parent_path() / image).string();
         }
     }
-    return new_boundaries;
+    return "";
 }
 
-Map MapData::copy_map(Map map){
+OccupancyGrid MapData::copy_boundaries(const Map& map){
+    return map.boundaries.clone();
+}
+
+Map MapData::copy_map(const Map& map){
     Map new_map;
     new_map.px_width = map.px_width;
     new_map.px_height = map.px_height;
     new_map.m_width = map.m_width;
     new_map.m_height = map.m_height;
+    new_map.resolution = map.resolution;
     new_map.boundaries = MapData::copy_boundaries(map);
+    new_map.version = map.version;
     return new_map;
 }
 
-void MapData::inflate_pixel(int** nb, int width, int height, int col, int row, int buffer_size){
+Map::Map() : version(MapData::new_version()) {}
+
+// Versions are unique across maps so derived data never mistakes one map for another
+uint64_t MapData::new_version(){
+    static std::atomic<uint64_t> last_version(0);
+    return ++last_version;
+}
+
+void MapData::inflate_pixel(OccupancyGrid& nb, int width, int height, int col, int row, int buffer_size){
     int dx = buffer_size/2;
     int dy = buffer_size/2;
     if(dx == 0 && dy == 0) nb[row][col] = OBSTACLE_INT;
     else{
-        for(int y = row-dy; y <= row+dy; y++){
-            for(int x = col-dx; x <= col+dx; x++){
-                if(y >= 0 && y < height && x >= 0 && x < width && nb[y][x] != OBSTACLE_INT){
-                    nb[y][x] = INFLATE_INT;
-                }
+        // Clip inflation window to the grid
+        int x0 = std::max(col-dx, 0), x1 = std::min(col+dx, width-1);
+        int y0 = std::max(row-dy, 0), y1 = std::min(row+dy, height-1);
+        GridView window = nb.view(x0, y0, x1-x0+1, y1-y0+1);
+        for(int y = 0; y < window.get_height(); y++){
+            int8_t* window_row = window[y];
+            for(int x = 0; x < window.get_width(); x++){
+                if(window_row[x] != OBSTACLE_INT) window_row[x] = INFLATE_INT;
             }
-        }  
-    }    
+        }
+    }
 }
 
-int** MapData::inflate_boundaries(Map map, int buffer_size){
+OccupancyGrid MapData::inflate_boundaries(const Map& map, int buffer_size){
     // Allocate new boundary
-    int** new_boundaries = MapData::copy_boundaries(map);
+    OccupancyGrid new_boundaries = MapData::copy_boundaries(map);
      
     // Expand boundary based on buffer size
     for(int row = 0; row <= map.px_height-1; row++){
@@ -160,16 +237,13 @@ int** MapData::inflate_boundaries(Map map, int buffer_size){
         }
     }
 
-    //De-allocate old boundaries
-    for(int l = 0; l < map.px_height; l++) delete map.boundaries[l];
-    delete[] map.boundaries;
     // return inflated boundary
     return new_boundaries;
 }
 
-int** MapData::remove_boundary_inflation(Map map){
+OccupancyGrid MapData::remove_boundary_inflation(const Map& map){
     // Allocate new boundary
-    int** original_boundaries = MapData::copy_boundaries(map);
+    OccupancyGrid original_boundaries = MapData::copy_boundaries(map);
 
     // Remove inflation from boundaries
     for(int row = 0; row <= map.px_height-1; row++){
@@ -180,17 +254,14 @@ int** MapData::remove_boundary_inflation(Map map){
         }
     }
 
-    //De-allocate old boundaries
-    for(int l = 0; l < map.px_height; l++) delete map.boundaries[l];
-    delete[] map.boundaries;
-    // return inflated boundary
+    // return boundary without inflation
     return original_boundaries;
 }
 
-void MapData::inflate_point(Map map, cell pt, int buffer_size){
+void MapData::inflate_point(Map& map, cell pt, int buffer_size){
     int dx = buffer_size/2;
     int dy = buffer_size/2;
-    int** b = map.boundaries;
+    OccupancyGrid& b = map.boundaries;
     int cell_val = map.boundaries[pt.second][pt.first];
     for(int y = pt.second-dy; y <= pt.second+dy; y++){
         for(int x = pt.first-dx; x <= pt.first+dx; x++){
@@ -202,13 +273,50 @@ void MapData::inflate_point(Map map, cell pt, int buffer_size){
     }
 }
 
-Map MapData::add_path_to_map(Map map, vector<cell> path, cell sp, cell ep){
+// Cells changed by inflate_point, clipped to the map
+CellRect MapData::point_rect(const Map& map, cell pt, int buffer_size){
+    int d = buffer_size/2;
+    int x0 = std::max(pt.first-d, 0), x1 = std::min(pt.first+d, map.px_width-1);
+    int y0 = std::max(pt.second-d, 0), y1 = std::min(pt.second+d, map.px_height-1);
+    return CellRect{x0, y0, std::max(x1-x0+1, 0), std::max(y1-y0+1, 0)};
+}
+
+void MapData::mark_dirty(Map& map, CellRect rect){
+    int x0 = std::max(rect.col, 0), x1 = std::min(rect.col+rect.width, map.px_width);
+    int y0 = std::max(rect.row, 0), y1 = std::min(rect.row+rect.height, map.px_height);
+    if(x0 >= x1 || y0 >= y1) return;
+    uint64_t version = MapData::new_version();
+    map.edits.push_back(MapEdit{map.version, version, CellRect{x0, y0, x1-x0, y1-y0}});
+    map.version = version;
+    if(map.edits.size() > MAX_MAP_EDITS) map.edits.erase(map.edits.begin(), map.edits.begin()+MAX_MAP_EDITS/2);
+}
+
+// Collects the regions edited since the given version. Returns false if the
+// map no longer remembers that version, in which case everything is dirty.
+bool MapData::get_dirty_rects(const Map& map, uint64_t since_version, vector<CellRect>& rects){
+    rects.clear();
+    if(since_version == map.version) return true;
+    for(size_t i = 0; i < map.edits.size(); i++){
+        if(map.edits[i].prev_version != since_version) continue;
+        for(; i < map.edits.size(); i++) rects.push_back(map.edits[i].rect);
+        return true;
+    }
+    return false;
+}
+
+void MapData::copy_region(const Map& src, Map& dst, CellRect rect){
+    for(int row = rect.row; row < rect.row+rect.height; row++){
+        std::copy(src.boundaries[row]+rect.col, src.boundaries[row]+rect.col+rect.width, dst.boundaries[row]+rect.col);
+    }
+}
+
+Map MapData::add_path_to_map(const Map& map, vector<cell> path, cell sp, cell ep){
     int path_val = 3;
     Map new_map =  MapData::add_path_to_map_with_value(map, path_val, path, sp, ep);
     return new_map;
 }
 
-Map MapData::add_path_to_map_with_value(Map map, int pixel_val, vector<cell> path, cell sp, cell ep){
+Map MapData::add_path_to_map_with_value(const Map& map, int pixel_val, vector<cell> path, cell sp, cell ep){
     Map new_map;
     new_map.px_height = map.px_height;
     new_map.px_width = map.px_width;
@@ -227,7 +335,7 @@ Map MapData::add_path_to_map_with_value(Map map, int pixel_val, vector<cell> pat
     return new_map;
 }
 
-Map MapData::debug_map(Map map, vector<cell> path, vector<cell> travelled, cell sp, cell ep){
+Map MapData::debug_map(const Map& map, vector<cell> path, vector<cell> travelled, cell sp, cell ep){
     Map new_map;
     new_map.px_height = map.px_height;
     new_map.px_width = map.px_width;
@@ -247,43 +355,21 @@ Map MapData::debug_map(Map map, vector<cell> path, vector<cell> travelled, cell
     return new_map;
 }
 
-Graph MapData::get_graph_from_map(Map map){
-    Graph graph;
+Graph MapData::get_graph_from_map(const Map& map){
+    Graph graph(map.px_width, map.px_height);
+    FreeBitmap free_cells(map);
+    graph.reserve_edges((size_t)free_cells.count_free()*MAX_NEIGHBORS);
+    vector<uint8_t> masks(map.px_width);
     for(int row = 0; row < map.px_height; row++){
+        free_cells.row_neighbor_masks(row, masks.data());
         for(int col = 0; col < map.px_width; col++){
-            if(map.boundaries[row][col] == 0){
+            if(map.boundaries[row][col] == OPEN_SPACE_INT){
                 auto curr = cell{col, row};
-                // Up
-                if(row > 0 && map.boundaries[row-1][col] == 0){
-                    graph.add_edge(curr, cell{col, row-1}, 1);  
-                }
-                // Down
-                if (row < map.px_height - 1 && map.boundaries[row+1][col] == 0){
-                    graph.add_edge(curr, cell{col, row+1,}, 1);
-                }
-                // Left 
-                if(col > 0 && map.boundaries[row][col-1] == 0){
-                    graph.add_edge(curr, cell{col-1, row}, 1);
-                }
-                // Right
-                if(col < map.px_width - 1 && map.boundaries[row][col+1] == 0){
-                    graph.add_edge(curr, cell{col+1, row}, 1);
-                }
-                // Up-Left
-                if(row > 0 && col > 0 && map.boundaries[row-1][col-1] == 0){
-                    graph.add_edge(curr, cell{col-1, row-1,}, 2);
-                }
-                // Up-Right
-                if(row > 0 && col < map.px_width -1 && map.boundaries[row-1][col+1] == 0){
-                    graph.add_edge(curr, cell{col+1, row-1}, 2);
-                }
-                // Down-Left
-                if(row < map.px_height - 1 && col > 0 && map.boundaries[row+1][col-1] == 0){
-                    graph.add_edge(curr, cell{col-1, row+1, }, 2);
-                }
-                // Down-Right
-                if(row < map.px_height - 1 && col < map.px_width -1 && map.boundaries[row+1][col+1] == 0){
-                    graph.add_edge(curr, cell{col+1, row+1}, 2);
+                unsigned mask = masks[col];
+                while(mask){
+                    int d = __builtin_ctz(mask);
+                    mask &= mask-1;
+                    graph.add_edge(curr, cell{col + DIR_DX[d], row + DIR_DY[d]}, DIR_WEIGHT[d]);
                 }
                 // If cell has no neihbors add it to the graph
                 if(!graph.is_node_valid(curr)) graph.add_node(curr);
@@ -293,28 +379,74 @@ Graph MapData::get_graph_from_map(Map map){
     return graph;
 }
 
-void MapData::print_boundary(int** b, int width, int height){
+// Conservative occupancy pyramid: levels[0] is base and each level halves the
+// one below it, so a coarse path only crosses cells free at every resolution
+vector<FreeBitmap> MapData::get_occupancy_pyramid(const FreeBitmap& base, int min_size){
+    vector<FreeBitmap> levels = {base};
+    min_size = std::max(min_size, 1);
+    while(std::max(levels.back().get_width(), levels.back().get_height()) > min_size){
+        levels.push_back(downsample_occupancy(levels.back()));
+    }
+    return levels;
+}
+
+// A coarse cell is free only if all of its children are (children past the
+// edge of an odd-sized map are ignored)
+FreeBitmap MapData::downsample_occupancy(const FreeBitmap& fine){
+    int width = (fine.get_width()+1)/2, height = (fine.get_height()+1)/2;
+    auto coarse = FreeBitmap(width, height);
+    for(int row = 0; row < height; row++){
+        int r0 = 2*row, r1 = std::min(2*row+1, fine.get_height()-1);
+        for(int col = 0; col < width; col++){
+            int c0 = 2*col, c1 = std::min(2*col+1, fine.get_width()-1);
+            if(fine.is_free(c0, r0) && fine.is_free(c1, r0) && fine.is_free(c0, r1) && fine.is_free(c1, r1)){
+                coarse.set_free(col, row, true);
+            }
+        }
+    }
+    return coarse;
+}
+
+void MapData::print_boundary(const OccupancyGrid& b, int width, int height){
     cout << "[\n";
     for(int row = 0; row < height; row++){
         cout << row << ": [";
         for(int col = 0; col < width; col++){
-            cout << b[row][col] << ",";
+            cout << (int)b[row][col] << ",";
         }
         cout << "]\n";
     }
     cout << "]\n";
 }
 
-void MapData::show_map(string title, Map map){
+static void set_cell_color(Mat& img, int col, int row, int cell_val){
+    if(cell_val == MapData::PATH_INT) img.at<Vec3b>(Point(col,row)) = cv::Vec3b(0,0,255);                 // Path color
+    else if(cell_val == MapData::TRAVELLED_INT) img.at<Vec3b>(Point(col,row)) = cv::Vec3b(230,216,173);   // Visted node color
+    else if(cell_val == MapData::NAV_POINT_INT) img.at<Vec3b>(Point(col,row)) = cv::Vec3b(128,0,128);     // Start and goal node
+    else if(cell_val == MapData::OPEN_SPACE_INT) img.at<Vec3b>(Point(col,row)) = cv::Vec3b(255,255,255);  // Empty space color
+    else if(cell_val <= MapData::OBSTACLE_INT) img.at<Vec3b>(Point(col,row)) = cv::Vec3b(0,0,0);          // Obstacle color
+}
+
+void MapData::show_map(string title, const Map& map){
     Mat img(map.px_height, map.px_width, CV_8UC3);
     for(int row = 0; row < map.px_height; row++){
-        for(int col = 0; col < map.px_width; col++){
-            if(map.boundaries[row][col] == PATH_INT) img.at<Vec3b>(Point(col,row)) = cv::Vec3b(0,0,255);            // Path color
-            else if(map.boundaries[row][col] == TRAVELLED_INT) img.at<Vec3b>(Point(col,row)) = cv::Vec3b(230,216,173);   // Visted node color
-            else if(map.boundaries[row][col] == NAV_POINT_INT) img.at<Vec3b>(Point(col,row)) = cv::Vec3b(128,0,128);     // Start and goal node
-            else if(map.boundaries[row][col] == OPEN_SPACE_INT) img.at<Vec3b>(Point(col,row)) = cv::Vec3b(255,255,255);   // Empty space color
-            else if(map.boundaries[row][col] <= OBSTACLE_INT) img.at<Vec3b>(Point(col,row)) = cv::Vec3b(0,0,0);          // Obstacle color
-        }
+        for(int col = 0; col < map.px_width; col++) set_cell_color(img, col, row, map.boundaries[row][col]);
+    }
+    cout << "Showing image: " << title;
+    cout << " (press \'q\' to quit)" << endl;
+    imshow(title, img);
+    if(waitKey(0) && 0xFF == 'q') destroyAllWindows();
+}
+
+// Draws the base map, then the overlay cells on top of it
+void MapData::show_map(string title, const LayeredMap& map){
+    const Map& base = map.get_base();
+    Mat img(base.px_height, base.px_width, CV_8UC3);
+    for(int row = 0; row < base.px_height; row++){
+        for(int col = 0; col < base.px_width; col++) set_cell_color(img, col, row, base.boundaries[row][col]);
+    }
+    for(auto& layer: map.get_layers()){
+        for(auto& oc: layer) set_cell_color(img, oc.col, oc.row, oc.val);
     }
     cout << "Showing image: " << title;
     cout << " (press \'q\' to quit)" << endl;
@@ -323,7 +455,7 @@ void MapData::show_map(string title, Map map){
 }
 
 // Rotates map 90 degrees clockwise
-cell MapData::POSE2PIXEL(Map map, float x, float y){
+cell MapData::POSE2PIXEL(const Map& map, float x, float y){
     cell px;
     float x_pt_res = map.m_width*(1.0/map.px_width);
     float y_pt_res = map.m_height*(1.0/map.px_height);
@@ -333,7 +465,7 @@ cell MapData::POSE2PIXEL(Map map, float x, float y){
 }
  
 // Rotates map 90 degrees counter-clockwise
-pair<float, float> MapData::PIXEL2POSE(Map map, cell px){
+pair<float, float> MapData::PIXEL2POSE(const Map& map, cell px){
     pair<float, float> pose;
     float x_pt_res = map.m_width*(1.0/map.px_width);
     float y_pt_res = map.m_height*(1.0/map.px_height);
@@ -0,0 +1,57 @@
+#include <cstring>
+
+#include "occupancy_grid.hpp"
+
+void GridView::fill(int8_t val){
+    for(int row = 0; row < height; row++) std::memset((*this)[row], val, width);
+}
+
+OccupancyGrid::OccupancyGrid(int width, int height, int8_t fill_val)
+    : width(width), height(height), stride(width){
+    owned.reset(new int8_t[(size_t)width*height]);
+    cells = owned.get();
+    std::memset(cells, fill_val, (size_t)width*height);
+}
+
+OccupancyGrid::OccupancyGrid(int8_t* data, int width, int height, int stride)
+    : cells(data), width(width), height(height), stride(stride > 0 ? stride : width) {}
+
+OccupancyGrid OccupancyGrid::wrap(cv::Mat& mat){
+    if(mat.channels() != 1 || (mat.depth() != CV_8S && mat.depth() != CV_8U)){
+        throw std::invalid_argument("Occupancy grid can only wrap single channel 8-bit matrices");
+    }
+    return OccupancyGrid(reinterpret_cast<int8_t*>(mat.data), mat.cols, mat.rows, (int)mat.step);
+}
+
+OccupancyGrid::OccupancyGrid(OccupancyGrid&& other) noexcept
+    : owned(std::move(other.owned)), cells(other.cells),
+      width(other.width), height(other.height), stride(other.stride){
+    other.cells = nullptr;
+    other.width = other.height = other.stride = 0;
+}
+
+OccupancyGrid& OccupancyGrid::operator=(OccupancyGrid&& other) noexcept{
+    if(this != &other){
+        owned = std::move(other.owned);
+        cells = other.cells;
+        width = other.width;
+        height = other.height;
+        stride = other.stride;
+        other.cells = nullptr;
+        other.width = other.height = other.stride = 0;
+    }
+    return *this;
+}
+
+OccupancyGrid OccupancyGrid::clone() const{
+    OccupancyGrid copy(width, height);
+    for(int row = 0; row < height; row++) std::memcpy(copy[row], (*this)[row], width);
+    return copy;
+}
+
+GridView OccupancyGrid::view(int col, int row, int view_width, int view_height){
+    if(col < 0 || row < 0 || col+view_width > width || row+view_height > height){
+        throw std::out_of_range("Grid view is outside of grid bounds");
+    }
+    return GridView(cells + (size_t)row*stride + col, view_width, view_height, stride);
+}
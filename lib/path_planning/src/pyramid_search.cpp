@@ -0,0 +1,185 @@
+#include <mutex>
+
+#include "pyramid_search.hpp"
+#include "best_first_search.hpp"
+
+using namespace std::chrono;
+
+// Same scheme as JPS::get_jump_table, plus the min_size the pyramid was cut at
+shared_ptr<const PyramidSearch::Pyramid> PyramidSearch::get_pyramid(const GridGraph& g, int min_size){
+    static std::mutex cache_mutex;
+    static shared_ptr<const Pyramid> cached;
+    static uint64_t cached_version = 0;
+    static int cached_min_size = 0;
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    uint64_t version = g.get_map_version();
+    if(cached && version == cached_version && min_size == cached_min_size &&
+       (*cached)[0].get_width() == g.get_width() && (*cached)[0].get_height() == g.get_height()) return cached;
+    cached = make_shared<const Pyramid>(MapData::get_occupancy_pyramid(g.get_free_bitmap(), min_size));
+    cached_version = version;
+    cached_min_size = min_size;
+    return cached;
+}
+
+PyramidSearch::PyramidSearch(const PlanningGraph& g, int min_size) : tree(&g){
+    auto grid = dynamic_cast<const GridGraph*>(&g);
+    if(grid) levels = PyramidSearch::get_pyramid(*grid, min_size);
+    else{
+        auto base = FreeBitmap(g.get_width(), g.get_height());
+        for(auto node: g.get_nodes()) base.set_free(node.first, node.second, true);
+        levels = make_shared<const Pyramid>(MapData::get_occupancy_pyramid(base, min_size));
+    }
+    states.resize(levels->size());
+    for(size_t i = 0; i < levels->size(); i++) states[i].init((*levels)[i].get_width(), (*levels)[i].get_height());
+}
+
+void PyramidSearch::LevelState::init(int width, int height){
+    this->width = width;
+    tiles_wide = (width + TILE_MASK) >> TILE_SHIFT;
+    tiles.resize((size_t)tiles_wide*((height + TILE_MASK) >> TILE_SHIFT));
+}
+
+bool PyramidSearch::timed_out(){
+    return high_resolution_clock::now() >= deadline;
+}
+
+// Marks the children of every cell of level+1 within radius of coarse_path.
+// Returns false when the corridor would cover most of the level anyway.
+bool PyramidSearch::mark_corridor(int level, const vector<cell>& coarse_path, int radius){
+    auto& coarse = (*levels)[level+1];
+    auto& fine = (*levels)[level];
+    size_t side = 2*radius+1;
+    if(coarse_path.size()*side*side >= (size_t)coarse.get_width()*coarse.get_height()) return false;
+    auto& st = states[level];
+    corridor_id++;
+    for(auto p: coarse_path){
+        for(int y = std::max(p.second-radius, 0); y <= std::min(p.second+radius, coarse.get_height()-1); y++){
+            for(int x = std::max(p.first-radius, 0); x <= std::min(p.first+radius, coarse.get_width()-1); x++){
+                for(int row = 2*y; row <= std::min(2*y+1, fine.get_height()-1); row++){
+                    for(int col = 2*x; col <= std::min(2*x+1, fine.get_width()-1); col++){
+                        st.at({col, row}).corridor = corridor_id;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// A* on one level of the pyramid, optionally restricted to the cells marked
+// by mark_corridor(). Start and goal are always open, even when their coarse
+// cells are not.
+bool PyramidSearch::search(int level, bool in_corridor, vector<cell>& path){
+    auto& bits = (*levels)[level];
+    auto& st = states[level];
+    int width = bits.get_width();
+    search_id++;
+    cell s = {start.first >> level, start.second >> level}, t = {goal.first >> level, goal.second >> level};
+    auto id = [&](cell c){ return (size_t)c.second*width + c.first; };
+    auto h = [&](cell c){ return OctileHeuristic::cost<int>(c, t); };
+
+    queue = BucketQueue(2*MapData::DIR_WEIGHT[MAX_NEIGHBORS-1]);
+    auto& start_state = st.at(s);
+    start_state.visited = search_id;
+    start_state.dist = 0;
+    start_state.parent_dir = -1;
+    queue.push(cell_id(id(s)), h(s));
+    int expanded = 0;
+    while(!queue.empty()){
+        int key;
+        uint32_t curr = queue.pop(key).v;
+        cell c = {(int)(curr % width), (int)(curr / width)};
+        int d = st.at(c).dist;
+        if(key > d + h(c)) continue; // Stale entry
+        if(c == t){
+            path.clear();
+            for(cell p = t; p != s; ){
+                path.push_back(p);
+                int dir = st.at(p).parent_dir;
+                p = {p.first - MapData::DIR_DX[dir], p.second - MapData::DIR_DY[dir]};
+            }
+            path.push_back(s);
+            std::reverse(path.begin(), path.end());
+            return true;
+        }
+        if(++expanded % TIMEOUT_CHECK_INTERVAL == 0 && timed_out()) return false;
+        if(level == 0) travelled.push_back(c);
+        for(int dir = 0; dir < MAX_NEIGHBORS; dir++){
+            cell child = {c.first + MapData::DIR_DX[dir], c.second + MapData::DIR_DY[dir]};
+            if(child != t && !bits.is_free(child.first, child.second)) continue;
+            if(in_corridor){
+                auto marked = st.find(child);
+                if(!marked || marked->corridor != corridor_id) continue;
+            }
+            int nd = d + MapData::DIR_WEIGHT[dir];
+            auto& child_state = st.at(child);
+            if(child_state.visited == search_id && nd >= child_state.dist) continue;
+            child_state.visited = search_id;
+            child_state.dist = nd;
+            child_state.parent_dir = dir;
+            queue.push(cell_id(id(child)), nd + h(child));
+        }
+    }
+    return false;
+}
+
+void PyramidSearch::solve(cell sp, cell ep, int timeout){
+    start = sp;
+    goal = ep;
+    goal_reached = false;
+    path.clear();
+    travelled.clear();
+    dist = 0;
+    start_level = -1;
+    widenings = 0;
+    if(!tree->is_node_valid(sp) || !tree->is_node_valid(ep)) return;
+    deadline = high_resolution_clock::now() + milliseconds(timeout);
+
+    vector<cell> coarse, fine;
+    int top = levels->size()-1;
+    while(top >= 0){
+        if(!search(top, false, coarse)){
+            if(timed_out()) return;
+            top--;
+            continue;
+        }
+        // Refine one level at a time, widening the corridor until it covers
+        // the whole level
+        int level = top;
+        for(; level > 0; level--){
+            bool found = false;
+            for(int radius = CORRIDOR_RADIUS; ; radius *= 2){
+                bool in_corridor = mark_corridor(level-1, coarse, radius);
+                found = search(level-1, in_corridor, fine);
+                if(found || !in_corridor || timed_out()) break;
+                widenings++;
+            }
+            if(!found) break;
+            coarse.swap(fine);
+        }
+        if(level == 0){
+            goal_reached = true;
+            start_level = top;
+            path = coarse;
+            dist = states[0].at(ep).dist;
+            return;
+        }
+        if(timed_out()) return;
+        // The level below has no path even without a corridor, so start over
+        // from the level under that one
+        top = level-2;
+    }
+}
+
+pair<vector<cell>, float> PyramidSearch::reconstruct_path(cell sp, cell ep){
+    auto data = pair<vector<cell>, float>();
+    data.second = std::numeric_limits<float>::infinity();
+    if(!goal_reached) return data;
+    data.first = path;
+    data.second = dist;
+    return data;
+}
+
+vector<cell> PyramidSearch::get_travelled_nodes(){
+    return travelled;
+}
@@ -4,9 +4,12 @@ using namespace std::chrono;
 
 const float PI = 3.14159;
 
-RRTStar::RRTStar(Graph g, int iter){
-    tree = g;
+RRTStar::RRTStar(const PlanningGraph& g, int iter) : tree(g){
     max_iter = iter;
+    int width = tree.get_width(), height = tree.get_height();
+    layout = CellLayout(width, height);
+    cost_map = CellArray<float>(width, height, 0);
+    parent = CellArray<cell_id>(width, height, cell_id());
     all_valid_nodes = tree.get_nodes();
     goal_reached = false;
 }
@@ -25,17 +28,18 @@ void RRTStar::solve(cell sp, cell ep, int timeout){
         //cout << "Random node: (" << random_node.first <<"," <<random_node.second <<")\n";
         //cout << "Nearest node: (" << nearest_node.first <<"," << nearest_node.second <<")\n";
         //cout << "New node: (" << new_node.first <<"," <<new_node.second <<")\n";
+        if(!layout.in_bounds(new_node)) continue;
         if(tree.is_node_valid(new_node)){
             auto neighbors = find_neighbors(node_list, new_node);
             new_node = choose_parent(neighbors, nearest_node, new_node);
             node_list.push_back(new_node);
             rewire(new_node, neighbors);
-            travelled.push_back(new_node);
+            travelled.push_back(layout.to_id(new_node));
         }   
         if(RRTStar::euclidean_distance(new_node,ep) <= 1.5){
             goal_reached = true;
-            if(parent[new_node] != ep) {
-                parent[ep] = new_node;
+            if(parent[new_node] != layout.to_id(ep)) {
+                parent[ep] = layout.to_id(new_node);
                 cost_map[ep] = cost_map[new_node] + euclidean_distance(new_node,ep);
             }
             break;
@@ -52,12 +56,13 @@ void RRTStar::solve(cell sp, cell ep, int timeout){
 pair<vector<cell>, float> RRTStar::reconstruct_path(cell sp, cell ep){
     auto data = pair<vector<cell>, float>();
     if(sp != ep) data.first.push_back(ep);
-    auto curr = ep;
-    while(curr != sp){
+    cell_id curr = layout.to_id(ep), start_id = layout.to_id(sp);
+    while(curr != start_id){
         curr = parent[curr];
-        if(curr == cell{0, 0}) break; // Stop infinite loop if path not found
-        data.first.insert(data.first.begin(), curr);
+        if(!curr.is_valid()) break; // Stop infinite loop if path not found
+        data.first.push_back(layout.to_cell(curr));
     }
+    std::reverse(data.first.begin(), data.first.end());
     data.second = cost_map[ep];
     return data;
 }
@@ -75,7 +80,7 @@ cell RRTStar::get_random_node(){
     return random_node;
 }
 
-cell RRTStar::get_nearest_node(vector<cell> node_list, cell random_node){
+cell RRTStar::get_nearest_node(const vector<cell>& node_list, cell random_node){
     cell nearest_node;
     float min_dist = std::numeric_limits<float>::infinity();
     for(auto n: node_list){
@@ -88,7 +93,7 @@ cell RRTStar::get_nearest_node(vector<cell> node_list, cell random_node){
     return nearest_node;
 }
 
-vector<cell> RRTStar::find_neighbors(vector<cell> node_list, cell node){
+vector<cell> RRTStar::find_neighbors(const vector<cell>& node_list, cell node){
     vector<cell> neighbors;
     for(cell n: node_list){
         if(RRTStar::euclidean_distance(n, node) < 2) neighbors.push_back(n);
@@ -101,12 +106,13 @@ cell RRTStar::steer(cell from_node, cell to_node){
     int closest_x = std::round(from_node.first + cos(theta*180.0/PI));
     int closest_y = std::round(from_node.second + sin(theta*180.0/PI));
     cell new_node = {closest_x, closest_y};
+    if(!layout.in_bounds(new_node)) return new_node;
     cost_map[new_node] = cost_map[from_node] + RRTStar::euclidean_distance(from_node, new_node);
-    parent[new_node] = from_node;
+    parent[new_node] = layout.to_id(from_node);
     return new_node;
 }
 
-cell RRTStar::choose_parent(vector<cell> neighbors, cell nearest_node, cell new_node){
+cell RRTStar::choose_parent(const vector<cell>& neighbors, cell nearest_node, cell new_node){
     //std::complex<float> nv (new_node.first-nearest_node.first, new_node.second-nearest_node.second); // norm of vector
     float min_cost = cost_map[nearest_node] + euclidean_distance(new_node,nearest_node);//sqrt(std::norm(nv));
     cell best_node = {nearest_node.first, nearest_node.second};
@@ -119,16 +125,16 @@ cell RRTStar::choose_parent(vector<cell> neighbors, cell nearest_node, cell new_
         }
     }
     cost_map[new_node] = min_cost;
-    parent[new_node] = best_node;
+    parent[new_node] = layout.to_id(best_node);
     return new_node;
 }
 
-void RRTStar::rewire(cell new_node, vector<cell> neighbors){
+void RRTStar::rewire(cell new_node, const vector<cell>& neighbors){
     for(auto n: neighbors){
         //std::complex<float> nv (n.first-new_node.first, n.second-new_node.second); // norm of vector
         float cost = cost_map[new_node] + euclidean_distance(new_node,n);//sqrt(std::norm(nv));  
         if(cost < cost_map[n] && tree.is_node_valid(new_node)){
-            parent[n] = new_node;
+            parent[n] = layout.to_id(new_node);
             cost_map[n] = cost;
         }
     }
@@ -139,5 +145,8 @@ float RRTStar::euclidean_distance(cell a, cell b){
 }
 
 vector<cell> RRTStar::get_travelled_nodes(){
-    return travelled;
+    vector<cell> nodes;
+    nodes.reserve(travelled.size());
+    for(auto t: travelled) nodes.push_back(layout.to_cell(t));
+    return nodes;
 }
\ No newline at end of file
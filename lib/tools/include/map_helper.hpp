@@ -4,22 +4,29 @@
 #include <string>
 
 #include "map_data.hpp"
+#include "cell_layout.hpp"
 
 using namespace std;
 
+// Path and travelled nodes are stored as cell ids of the planned graph
 struct AlgoResult{
     string type;
     int duration;
-    vector<cell> path;
-    vector<cell> travelled;
+    CellLayout layout;
+    vector<cell_id> path;
+    vector<cell_id> travelled;
     float dist;
+    vector<cell> get_path() const;
+    vector<cell> get_travelled() const;
 };
 
 class MapHelper {
 public:
     static cell get_positon(string pos_str);
-    static void add_result(vector<AlgoResult> &results, string algo_type, int duration,
-                           vector<cell> path, vector<cell> travelled, float dist);
+    static AlgoResult make_result(string algo_type, int duration, const CellLayout& layout,
+                                  const vector<cell>& path, const vector<cell>& travelled, float dist);
+    static void add_result(vector<AlgoResult> &results, string algo_type, int duration, const CellLayout& layout,
+                           const vector<cell>& path, const vector<cell>& travelled, float dist);
 };
 
 #endif // MAP_HELPER_HPP
@@ -16,7 +16,34 @@ cell MapHelper::get_positon(string pos_str){
     return pos;
 }
 
-void MapHelper::add_result(vector<AlgoResult> &results, string algo_type, int duration,
-                           vector<cell> path, vector<cell> travelled, float dist){
-    results.push_back(AlgoResult{algo_type, duration, path, travelled, dist});
+static vector<cell_id> to_ids(const CellLayout& layout, const vector<cell>& cells){
+    vector<cell_id> ids;
+    ids.reserve(cells.size());
+    for(auto c: cells) ids.push_back(layout.to_id(c));
+    return ids;
+}
+
+static vector<cell> to_cells(const CellLayout& layout, const vector<cell_id>& ids){
+    vector<cell> cells;
+    cells.reserve(ids.size());
+    for(auto id: ids) cells.push_back(layout.to_cell(id));
+    return cells;
+}
+
+vector<cell> AlgoResult::get_path() const{
+    return to_cells(layout, path);
+}
+
+vector<cell> AlgoResult::get_travelled() const{
+    return to_cells(layout, travelled);
+}
+
+AlgoResult MapHelper::make_result(string algo_type, int duration, const CellLayout& layout,
+                                  const vector<cell>& path, const vector<cell>& travelled, float dist){
+    return AlgoResult{algo_type, duration, layout, to_ids(layout, path), to_ids(layout, travelled), dist};
+}
+
+void MapHelper::add_result(vector<AlgoResult> &results, string algo_type, int duration, const CellLayout& layout,
+                           const vector<cell>& path, const vector<cell>& travelled, float dist){
+    results.push_back(make_result(algo_type, duration, layout, path, travelled, dist));
 }
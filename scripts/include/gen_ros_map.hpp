@@ -29,10 +29,9 @@ class GenerateMap{
                 stringstream ss(line);
                 getline(ss, value, ' ');
                 map.px_height = stoi(value);
-                map.boundaries = new int*[map.px_height];
                 getline(ss, value, ' ');
                 map.px_width = stoi(value);
-                for(int k = 0; k < map.px_height; k++) map.boundaries[k] = new int[map.px_width];
+                map.boundaries = OccupancyGrid(map.px_width, map.px_height);
                 for(int row=0; row<map.px_height; row++){
                     getline(txt_input, line);
                     stringstream ss(line);
@@ -51,7 +50,7 @@ class GenerateMap{
             return map;
         }
 
-        static void generate_map_pgm(Map map, fs::path path, string title){
+        static void generate_map_pgm(const Map& map, fs::path path, string title){
             string filename = title + ".pgm";
             fs::path filepath = path / filename.c_str();
             std::ofstream pgm_output(filepath, std::ios_base::binary | std::ios_base::out);
@@ -84,7 +83,7 @@ class GenerateMap{
             }
         }
 
-        static void generate_map_yaml(Map map, fs::path path, string title){
+        static void generate_map_yaml(const Map& map, fs::path path, string title){
             string filename = title + ".yaml";
             fs::path filepath = path / filename.c_str();
             std::ofstream yaml_output(filepath, std::ios_base::out);
@@ -1,21 +1,37 @@
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <chrono>
 #include <iomanip>
 #include <cstring>
+#include <algorithm>
 
 #include "map_data.hpp"
+#include "grid_graph.hpp"
+#include "map_cache.hpp"
+#include "layered_map.hpp"
 #include "bfs.hpp"
 #include "a_star.hpp"
-//#include "d_star_lite.hpp"
+#include "dijkstra.hpp"
+#include "jps.hpp"
+#include "adaptive_a_star.hpp"
+#include "landmarks.hpp"
+#include "bidirectional_search.hpp"
+#include "ara_star.hpp"
+#include "contraction_hierarchy.hpp"
+#include "hpa_star.hpp"
+#include "pyramid_search.hpp"
+#include "cost_to_go.hpp"
+#include "components.hpp"
+#include "d_star_lite.hpp"
 #include "rrt_star.hpp"
 #include "time_helper.hpp"
 #include "map_helper.hpp"
 
 struct Parameters{
-    string algo, map_yaml;
-    bool show_debug = false, get_help = false, kill_script = false;
+    string algo, map_yaml, edits_file, starts_file;
+    bool show_debug = false, get_help = false, kill_script = false, use_cache = true;
     int inflate_size = 3, max_iter = 10000;
     cell start, goal;
 };
@@ -27,6 +43,19 @@ vector<AlgoResult> algo_results;
 const string BFS_ID = "bfs";
 const string A_STAR_ID = "a-star";
 const string RRT_STAR_ID = "rrt-star";
+const string DIJKSTRA_ID = "dijkstra";
+const string BUCKET_A_STAR_ID = "bucket-a-star";
+const string JPS_ID = "jps";
+const string ADAPTIVE_A_STAR_ID = "adaptive-a-star";
+const string ALT_A_STAR_ID = "alt-a-star";
+const string BI_BFS_ID = "bi-bfs";
+const string BI_A_STAR_ID = "bi-a-star";
+const string D_STAR_LITE_ID = "d-star-lite";
+const string ARA_STAR_ID = "ara-star";
+const string CH_ID = "ch";
+const string HPA_STAR_ID = "hpa-star";
+const string PYRAMID_ID = "pyramid";
+const string COST_TO_GO_ID = "cost-to-go";
 const string ALL_ID = "all";
 
 void print_help_menu(){
@@ -37,14 +66,26 @@ void print_help_menu(){
     cout << "   -i INFLATE_SIZE. --inflate-size INFLATE_SIZE\n";
     cout << "                                         Set size of boundaries (Default: 3).\n";
     cout << "   -a ALGORITHM, --algorithm ALGORITHM   Set executed algoritm to one of the following:\n";
-    cout << "                                         [bfs, a-star, rrt-star, all].\n";
+    cout << "                                         [bfs, a-star, dijkstra, bucket-a-star, jps,\n";
+    cout << "                                         adaptive-a-star, alt-a-star, bi-bfs, bi-a-star,\n";
+    cout << "                                         ara-star, ch, hpa-star, pyramid, cost-to-go, d-star-lite,\n";
+    cout << "                                         rrt-star, all].\n";
     cout << "   -l MAX_ITER, --max-iter MAX_ITER      Set limit the number of iterations executed.\n";
     cout << "                                         Only supported for sample-based methods (Default: 10000).\n";
     cout << "   -s START_POS, --start-pos START_POS   Set start position [Format: \"int,int\"].\n";
     cout << "   -e END_POS, --end-pos END_POS         Set end position [Format: \"int,int\"].\n";
     cout << "   -d, --debug                           Provide more information for debugging.\n";
+    cout << "   -n, --no-cache                        Do not read or write the precomputed map cache\n";
+    cout << "                                         (<map>_inflate<INFLATE_SIZE>.rppc next to the yaml).\n";
     cout << "   -t TIMEOUT, timeout TIMEOUT           Set timeout limit for algorithm computation\n";
-    cout << "                                         (Default: 600000 ms).\n";
+    cout << "                                         (Default: 600000 ms). ara-star keeps the best path\n";
+    cout << "                                         found before the timeout.\n";
+    cout << "   -r EDITS_FILE, --replay EDITS_FILE    Replay map edits after the first d-star-lite or hpa-star\n";
+    cout << "                                         plan and report the latency of each replan. One edit\n";
+    cout << "                                         per line: \"draw x,y size\" or \"erase x,y size\".\n";
+    cout << "   -b STARTS_FILE, --batch STARTS_FILE   Plan from every start in STARTS_FILE to END_POS with one\n";
+    cout << "                                         cost-to-go field and report the latency of each query.\n";
+    cout << "                                         One start per line [Format: \"int,int\"].\n";
 }
 
 Parameters get_params(int argc, char* argv[]){
@@ -126,6 +167,9 @@ Parameters get_params(int argc, char* argv[]){
         else if(strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--debug") == 0){
             params.show_debug = true;
         }
+        else if(strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--no-cache") == 0){
+            params.use_cache = false;
+        }
         else if(strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--timeout") == 0){
             if (i+1 >= argc){
                 cout << "Mising timeout value" << endl;
@@ -144,6 +188,24 @@ Parameters get_params(int argc, char* argv[]){
                 }
             }
         }
+        else if(strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "--replay") == 0){
+            if(i+1 >= argc){
+                cout << "Mising edits file name" << endl;
+                params.kill_script = true;
+                break;
+            }
+            else params.edits_file = argv[i+1];
+            i++;
+        }
+        else if(strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "--batch") == 0){
+            if(i+1 >= argc){
+                cout << "Mising starts file name" << endl;
+                params.kill_script = true;
+                break;
+            }
+            else params.starts_file = argv[i+1];
+            i++;
+        }
         else if(strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0){
             params.get_help = true;
             break;
@@ -165,16 +227,17 @@ void print_results(AlgoResult ar, bool debug, int timeout){
         cout << "Elapsed Time: " << duration_converted.first << " " <<  duration_converted.second << endl;
 
     if(debug){
-        cout << "# of Nodes: " << ar.path.size() << endl;
+        auto path = ar.get_path();
+        cout << "# of Nodes: " << path.size() << endl;
         std::cout << "Path: [";
-        for(auto p: ar.path) std::cout << "(" << p.first << "," << p.second << "), ";
+        for(auto p: path) std::cout << "(" << p.first << "," << p.second << "), ";
         std::cout << "]\n";
     }
     std::cout << "Distance: " << ar.dist << std::endl;
 }
 
 bool is_valid_algo(string name){
-    vector<string> valid_algos = {BFS_ID, A_STAR_ID, RRT_STAR_ID, ALL_ID};
+    vector<string> valid_algos = {BFS_ID, A_STAR_ID, DIJKSTRA_ID, BUCKET_A_STAR_ID, JPS_ID, ADAPTIVE_A_STAR_ID, ALT_A_STAR_ID, BI_BFS_ID, BI_A_STAR_ID, ARA_STAR_ID, CH_ID, HPA_STAR_ID, PYRAMID_ID, COST_TO_GO_ID, D_STAR_LITE_ID, RRT_STAR_ID, ALL_ID};
     for(auto algo: valid_algos){
         if(name == algo) return true;
     }
@@ -182,16 +245,19 @@ bool is_valid_algo(string name){
 }
 
 void show_map(string title, Map &m, cell sp, cell ep, vector<cell> path, vector<cell> travelled, bool debug){
-    Map sm;
+    LayeredMap sm(m);
     if(debug) {
         title = "Debug " + title;
-        sm = MapData::debug_map(m, path, travelled, sp, ep);
+        sm.add_cells(sm.add_layer(), travelled, MapData::TRAVELLED_INT);
     }
-    else sm = MapData::add_path_to_map(m, path, sp, ep);
+    sm.add_path(sm.add_layer(), path, MapData::PATH_INT, MapData::PATH_SIZE);
+    int nav_layer = sm.add_layer();
+    sm.add_point(nav_layer, sp, MapData::NAV_POINT_INT, MapData::POINT_SIZE);
+    sm.add_point(nav_layer, ep, MapData::NAV_POINT_INT, MapData::POINT_SIZE);
     MapData::show_map(title, sm);
 }
 
-void run_bfs(Map &m, Graph g, bool debug){
+void run_bfs(Map &m, PlanningGraph &g, bool debug){
     cout << "BFS" << endl;
     auto bfs = BFS(g);
     
@@ -204,12 +270,12 @@ void run_bfs(Map &m, Graph g, bool debug){
     vector<cell> path = results.first;
     float dist = results.second;
     vector<cell> travelled = bfs.get_travelled_nodes();
-    AlgoResult ar = {BFS_ID, duration, path, travelled, dist};
+    AlgoResult ar = MapHelper::make_result(BFS_ID, duration, CellLayout(g.get_width(), g.get_height()), path, travelled, dist);
     print_results(ar, debug, COMPUTE_TIMEOUT);
     show_map("BFS", m, g.root, g.end, path, travelled, debug);
 }
 
-void run_astar(Map &m, Graph g, bool debug){
+void run_astar(Map &m, PlanningGraph &g, bool debug){
     cout << "A-STAR" << endl;
     auto as = AStar(g);
     
@@ -222,12 +288,302 @@ void run_astar(Map &m, Graph g, bool debug){
     vector<cell> path = results.first;
     float dist = results.second;
     vector<cell> travelled = as.get_travelled_nodes();
-    AlgoResult ar = {A_STAR_ID, duration, path, travelled, dist};
+    AlgoResult ar = MapHelper::make_result(A_STAR_ID, duration, CellLayout(g.get_width(), g.get_height()), path, travelled, dist);
     print_results(ar, debug, COMPUTE_TIMEOUT);
     show_map("A*", m, g.root, g.end, path, travelled, debug);
 }
 
-void run_rrt_star(Map &m, Graph g, int max_iter, bool debug){
+// Grid planners that share the BFS/A* interface. Queries far below the
+// millisecond resolution also print their time in microseconds with time_us.
+template<typename Planner>
+void run_grid_planner(Map &m, PlanningGraph &g, string id, string title, bool debug, Planner planner, bool time_us = false){
+    string upper = id;
+    std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+    cout << upper << endl;
+
+    auto start_time = TimeHelper::get_time("Start Time", true);
+    planner.solve(g.root, g.end, COMPUTE_TIMEOUT);
+    auto end_time = TimeHelper::get_time("End Time", true);
+    int duration = duration_cast<milliseconds>(end_time - start_time).count();
+    if(time_us) cout << "Query: " << duration_cast<microseconds>(end_time - start_time).count() << " us" << endl;
+
+    auto results = planner.reconstruct_path(g.root, g.end);
+    vector<cell> path = results.first;
+    float dist = results.second;
+    vector<cell> travelled = planner.get_travelled_nodes();
+    AlgoResult ar = MapHelper::make_result(id, duration, CellLayout(g.get_width(), g.get_height()), path, travelled, dist);
+    print_results(ar, debug, COMPUTE_TIMEOUT);
+    show_map(title, m, g.root, g.end, path, travelled, debug);
+}
+
+// Prints every path published before the deadline with its suboptimality bound
+void run_ara_star(Map &m, PlanningGraph &g, bool debug){
+    cout << "ARA-STAR" << endl;
+    auto ara = ARAStar(g);
+
+    auto start_time = TimeHelper::get_time("Start Time", true);
+    ara.solve(g.root, g.end, COMPUTE_TIMEOUT);
+    auto end_time = TimeHelper::get_time("End Time", true);
+    int duration = duration_cast<milliseconds>(end_time - start_time).count();
+
+    for(auto s: ara.get_solutions()){
+        cout << "Solution at " << s.time << " ms: weight " << s.weight << ", bound " << s.bound
+             << ", distance " << s.dist << endl;
+    }
+    if(ara.get_solutions().empty()) cout << "No path found before the deadline" << endl;
+    auto results = ara.reconstruct_path(g.root, g.end);
+    vector<cell> travelled = ara.get_travelled_nodes();
+    AlgoResult ar = MapHelper::make_result(ARA_STAR_ID, duration, CellLayout(g.get_width(), g.get_height()), results.first, travelled, results.second);
+    print_results(ar, debug, COMPUTE_TIMEOUT);
+    show_map("ARA*", m, g.root, g.end, results.first, travelled, debug);
+}
+
+// Applies an edit the way the GUI pen and eraser do. Returns false if the
+// line is not "draw x,y size" or "erase x,y size".
+bool apply_edit(Map &m, const string& line){
+    std::istringstream in(line);
+    string op, pos;
+    int size;
+    if(!(in >> op >> pos >> size) || (op != "draw" && op != "erase")) return false;
+    cell pt = MapHelper::get_positon(pos);
+    if(pt.first < 0 || pt.first >= m.px_width || pt.second < 0 || pt.second >= m.px_height) return false;
+    m.boundaries[pt.second][pt.first] = op == "draw" ? MapData::OBSTACLE_INT : MapData::OPEN_SPACE_INT;
+    MapData::inflate_point(m, pt, size);
+    MapData::mark_dirty(m, MapData::point_rect(m, pt, size));
+    return true;
+}
+
+// Applies every edit in edits_file to the map and calls replan() after each
+// one, which updates the planner and returns a summary of the new plan.
+// Prints the latency of each replan; returns how many there were.
+template<typename Replan>
+int replay_edits(Map &m, string edits_file, Replan replan){
+    std::ifstream file(edits_file);
+    if(!file.is_open()) cout << "Could not open edits file: " << edits_file << endl;
+    string line;
+    int num_replans = 0, line_num = 0;
+    double total_us = 0, max_us = 0;
+    while(std::getline(file, line)){
+        line_num++;
+        if(line.empty() || line[0] == '#') continue;
+        if(!apply_edit(m, line)){
+            cout << "Skipping invalid edit on line " << line_num << ": " << line << endl;
+            continue;
+        }
+        auto replan_start = high_resolution_clock::now();
+        string summary = replan();
+        auto replan_end = high_resolution_clock::now();
+        double us = duration_cast<microseconds>(replan_end - replan_start).count();
+        total_us += us;
+        max_us = std::max(max_us, us);
+        num_replans++;
+        cout << "Replan " << num_replans << " (" << line << "): " << us/1000 << " ms, " << summary << endl;
+    }
+    if(num_replans > 0){
+        cout << "Replans: " << num_replans << ", mean " << total_us/num_replans/1000
+             << " ms, max " << max_us/1000 << " ms" << endl;
+    }
+    return num_replans;
+}
+
+// Plans once, then repairs the plan after every edit in edits_file
+void run_d_star_lite(Map &m, GridGraph &g, string edits_file, bool debug){
+    cout << "D-STAR-LITE" << endl;
+    auto ds = DStarLite(g);
+
+    auto start_time = TimeHelper::get_time("Start Time", true);
+    ds.solve(g.root, g.end, COMPUTE_TIMEOUT);
+    auto end_time = TimeHelper::get_time("End Time", true);
+    int duration = duration_cast<milliseconds>(end_time - start_time).count();
+
+    auto results = ds.reconstruct_path(g.root, g.end);
+    vector<cell> travelled = ds.get_travelled_nodes();
+    AlgoResult ar = MapHelper::make_result(D_STAR_LITE_ID, duration, CellLayout(g.get_width(), g.get_height()), results.first, travelled, results.second);
+    print_results(ar, debug, COMPUTE_TIMEOUT);
+
+    if(!edits_file.empty()){
+        vector<CellRect> rects;
+        int num_replans = replay_edits(m, edits_file, [&](){
+            bool known = MapData::get_dirty_rects(m, ds.get_map_version(), rects);
+            g.update(m);
+            if(known) ds.update_graph(g, rects);
+            else ds = DStarLite(g);
+            ds.solve(g.root, g.end, COMPUTE_TIMEOUT);
+            std::ostringstream summary;
+            summary << ds.get_travelled_nodes().size() << " nodes expanded, distance " << ds.reconstruct_path(g.root, g.end).second;
+            return summary.str();
+        });
+        if(num_replans > 0){
+            results = ds.reconstruct_path(g.root, g.end);
+            travelled = ds.get_travelled_nodes();
+        }
+    }
+    show_map("D* Lite", m, g.root, g.end, results.first, travelled, debug);
+}
+
+// Builds the cluster abstraction and plans once, then rebuilds only the
+// clusters touched by every edit in edits_file and plans again
+void run_hpa_star(Map &m, GridGraph &g, string edits_file, bool debug){
+    auto build_start = high_resolution_clock::now();
+    auto hpa = HPAStar(g);
+    auto build_end = high_resolution_clock::now();
+    cout << "Cluster preprocessing: " << duration_cast<milliseconds>(build_end - build_start).count() << " ms ("
+         << hpa.get_num_clusters() << " clusters, " << hpa.get_num_entrances() << " entrances)" << endl;
+    cout << "HPA-STAR" << endl;
+
+    auto start_time = TimeHelper::get_time("Start Time", true);
+    hpa.solve(g.root, g.end, COMPUTE_TIMEOUT);
+    auto end_time = TimeHelper::get_time("End Time", true);
+    int duration = duration_cast<milliseconds>(end_time - start_time).count();
+
+    auto results = hpa.reconstruct_path(g.root, g.end);
+    vector<cell> travelled = hpa.get_travelled_nodes();
+    AlgoResult ar = MapHelper::make_result(HPA_STAR_ID, duration, CellLayout(g.get_width(), g.get_height()), results.first, travelled, results.second);
+    print_results(ar, debug, COMPUTE_TIMEOUT);
+
+    if(!edits_file.empty()){
+        vector<CellRect> rects;
+        int num_replans = replay_edits(m, edits_file, [&](){
+            bool known = MapData::get_dirty_rects(m, hpa.get_map_version(), rects);
+            g.update(m);
+            int rebuilt = hpa.get_num_clusters();
+            if(known) rebuilt = hpa.update_graph(g, rects);
+            else hpa = HPAStar(g);
+            hpa.solve(g.root, g.end, COMPUTE_TIMEOUT);
+            std::ostringstream summary;
+            summary << rebuilt << " clusters rebuilt, distance " << hpa.reconstruct_path(g.root, g.end).second;
+            return summary.str();
+        });
+        if(num_replans > 0){
+            results = hpa.reconstruct_path(g.root, g.end);
+            travelled = hpa.get_travelled_nodes();
+        }
+    }
+    show_map("HPA*", m, g.root, g.end, results.first, travelled, debug);
+}
+
+template<typename Planner>
+void run_grid_planner(Map &m, PlanningGraph &g, string id, string title, bool debug){
+    run_grid_planner(m, g, id, title, debug, Planner(g));
+}
+
+// Landmarks are read from the map cache when possible
+void run_alt_a_star(Map &m, GridGraph &g, MapCache &cache, bool use_cache, bool debug){
+    auto start_time = high_resolution_clock::now();
+    auto table = use_cache ? cache.get_landmarks(m, g, LandmarkTable::DEFAULT_LANDMARKS) :
+                             make_shared<const LandmarkTable>(g, LandmarkTable::DEFAULT_LANDMARKS);
+    auto end_time = high_resolution_clock::now();
+    cout << "Landmark preprocessing: " << duration_cast<milliseconds>(end_time - start_time).count() << " ms ("
+         << table->get_landmarks().size() << " landmarks)" << endl;
+    run_grid_planner(m, g, ALT_A_STAR_ID, "ALT A*", debug, ALTAStar(g, LandmarkHeuristic(table)));
+}
+
+// The hierarchy is read from the map cache when possible
+void run_contraction_hierarchy(Map &m, GridGraph &g, MapCache &cache, bool use_cache, bool debug){
+    auto start_time = high_resolution_clock::now();
+    auto ch = use_cache ? cache.get_contraction_hierarchy(m, g) : make_shared<const ContractionHierarchy>(g);
+    auto end_time = high_resolution_clock::now();
+    cout << "Contraction preprocessing: " << duration_cast<milliseconds>(end_time - start_time).count() << " ms ("
+         << ch->get_num_nodes() << " nodes, " << ch->get_num_shortcuts() << " shortcuts)" << endl;
+    run_grid_planner(m, g, CH_ID, "Contraction Hierarchy", debug, CHSearch(g, ch), true);
+}
+
+// The occupancy pyramid is fetched (built once per map version) before the timed search
+void run_pyramid_search(Map &m, GridGraph &g, bool debug){
+    auto start_time = high_resolution_clock::now();
+    auto pyramid = PyramidSearch(g);
+    auto end_time = high_resolution_clock::now();
+    cout << "Pyramid preprocessing: " << duration_cast<milliseconds>(end_time - start_time).count() << " ms ("
+         << pyramid.get_num_levels() << " levels)" << endl;
+    run_grid_planner(m, g, PYRAMID_ID, "Pyramid Search", debug, std::move(pyramid));
+}
+
+// The field of the goal is built before the timed descent
+void run_cost_to_go(Map &m, GridGraph &g, bool debug){
+    auto cache = make_shared<CostToGoCache>();
+    auto start_time = high_resolution_clock::now();
+    auto field = cache->get_field(g, g.end);
+    auto end_time = high_resolution_clock::now();
+    cout << "Cost-to-go preprocessing: " << duration_cast<milliseconds>(end_time - start_time).count() << " ms ("
+         << field->get_memory()/1024 << " KB)" << endl;
+    run_grid_planner(m, g, COST_TO_GO_ID, "Cost-to-Go Field", debug, CostToGoSearch(g, cache), true);
+}
+
+// Answers every start in starts_file from one cost-to-go field of the goal,
+// then compares the batch with A* from the first start that has a path.
+// One "x,y" start per line; lines starting with # are skipped.
+void run_cost_to_go_batch(Map &m, GridGraph &g, cell goal, string starts_file, bool debug){
+    cout << "COST-TO-GO BATCH" << endl;
+    std::ifstream file(starts_file);
+    if(!file.is_open()){
+        cout << "Could not open starts file: " << starts_file << endl;
+        return;
+    }
+    CostToGoCache cache;
+    auto build_start = high_resolution_clock::now();
+    auto field = cache.get_field(g, goal);
+    auto build_end = high_resolution_clock::now();
+    double build_us = duration_cast<microseconds>(build_end - build_start).count();
+    cout << "Field preprocessing: " << build_us/1000 << " ms (" << field->get_memory()/1024 << " KB)" << endl;
+
+    LayeredMap sm(m);
+    int path_layer = sm.add_layer(), nav_layer = sm.add_layer();
+    sm.add_point(nav_layer, goal, MapData::NAV_POINT_INT, MapData::POINT_SIZE);
+    string line;
+    int num_queries = 0, num_paths = 0, line_num = 0;
+    double total_us = 0, max_us = 0;
+    cell first_start = {-1, -1};
+    while(std::getline(file, line)){
+        line_num++;
+        if(line.empty() || line[0] == '#') continue;
+        cell start = MapHelper::get_positon(line);
+        if(!g.is_node_valid(start)){
+            cout << "Start " << line_num << " (" << line << "): invalid" << endl;
+            continue;
+        }
+        auto query_start = high_resolution_clock::now();
+        auto results = field->descend(g, start);
+        auto query_end = high_resolution_clock::now();
+        double us = duration_cast<nanoseconds>(query_end - query_start).count()/1000.0;
+        total_us += us;
+        max_us = std::max(max_us, us);
+        num_queries++;
+        if(results.first.empty()){
+            cout << "Start " << line_num << " (" << line << "): unreachable, " << us << " us" << endl;
+            continue;
+        }
+        num_paths++;
+        if(first_start.first < 0) first_start = start;
+        cout << "Start " << line_num << " (" << line << "): distance " << results.second << ", "
+             << results.first.size() << " nodes, " << us << " us" << endl;
+        if(debug){
+            cout << "Path: [";
+            for(auto p: results.first) cout << "(" << p.first << "," << p.second << "), ";
+            cout << "]\n";
+        }
+        sm.add_path(path_layer, results.first, MapData::PATH_INT, MapData::PATH_SIZE);
+        sm.add_point(nav_layer, start, MapData::NAV_POINT_INT, MapData::POINT_SIZE);
+    }
+    if(num_queries == 0){
+        cout << "No valid starts in " << starts_file << endl;
+        return;
+    }
+    cout << "Queries: " << num_queries << " (" << num_paths << " paths), mean " << total_us/num_queries
+         << " us, max " << max_us << " us" << endl;
+    cout << "Batch total: " << (build_us + total_us)/1000 << " ms" << endl;
+    if(first_start.first >= 0){
+        auto as = AStar(g);
+        auto start_time = high_resolution_clock::now();
+        as.solve(first_start, goal, COMPUTE_TIMEOUT);
+        auto end_time = high_resolution_clock::now();
+        double as_us = duration_cast<microseconds>(end_time - start_time).count();
+        cout << "A* from the first start: " << as_us/1000 << " ms, distance " << as.reconstruct_path(first_start, goal).second
+             << " (" << num_queries << " A* solves would take about " << as_us*num_queries/1000 << " ms)" << endl;
+    }
+    MapData::show_map("Cost-to-Go Batch", sm);
+}
+
+void run_rrt_star(Map &m, PlanningGraph &g, int max_iter, bool debug){
     cout << "RRT-STAR" << endl;
     auto rrt = RRTStar(g, max_iter);
     
@@ -242,7 +598,7 @@ void run_rrt_star(Map &m, Graph g, int max_iter, bool debug){
         path = results.first;
         float dist = results.second;
         travelled = rrt.get_travelled_nodes();
-        AlgoResult ar = {RRT_STAR_ID, duration, path, travelled, dist};
+        AlgoResult ar = MapHelper::make_result(RRT_STAR_ID, duration, CellLayout(g.get_width(), g.get_height()), path, travelled, dist);
         print_results(ar, debug, COMPUTE_TIMEOUT);
     }
     else {
@@ -252,6 +608,14 @@ void run_rrt_star(Map &m, Graph g, int max_iter, bool debug){
     show_map("RRT*", m, g.root, g.end, path, travelled, debug);
 }
 
+// Inflated map of the yaml, read through the cache unless it is disabled
+Map load_map(MapCache &cache, const Parameters &params){
+    if(params.use_cache) return cache.load_map(params.map_yaml, params.inflate_size);
+    Map map = MapData::get_map(params.map_yaml);
+    map.boundaries = MapData::inflate_boundaries(map, params.inflate_size);
+    return map;
+}
+
 int main(int argc, char* argv[]){
     auto params = get_params(argc, argv);
     /*cout << params.map_yaml << endl;
@@ -262,21 +626,66 @@ int main(int argc, char* argv[]){
     if(params.get_help){
         print_help_menu();
     }else if(!params.kill_script){
-        auto map = MapData::get_map(params.map_yaml);
-        map.boundaries = MapData::inflate_boundaries(map, params.inflate_size);
-        auto g = MapData::get_graph_from_map(map);
+        MapCache cache;
+        Map map = load_map(cache, params);
+        auto g = cache.get_graph(map);
+        // Batch mode only needs the goal
+        if(!params.starts_file.empty()){
+            if(g.is_node_valid(params.goal)) run_cost_to_go_batch(map, g, params.goal, params.starts_file, params.show_debug);
+            else cout << "End node: {" << params.goal.first << "," << params.goal.second << "} is invalid\n";
+            return 0;
+        }
         if(g.is_node_valid(params.start)) g.root = params.start;
         else cout << "Start node: {" << params.start.first << "," << params.start.second << "} is invalid\n"; 
         
         if(g.is_node_valid(params.goal)) g.end = params.goal;
         else cout << "End node: {" << params.goal.first << "," << params.goal.second << "} is invalid\n"; 
 
-        if(g.is_node_valid(params.start) && g.is_node_valid(params.goal)){
+        // A start and goal in different components are rejected before any
+        // planner floods the start component looking for a path
+        bool valid = g.is_node_valid(params.start) && g.is_node_valid(params.goal);
+        bool connected = false;
+        if(valid){
+            auto components = params.use_cache ? cache.get_components(map, g) : make_shared<const ComponentLabels>(g);
+            connected = components->connected(params.start, params.goal);
+            if(!connected) cout << "Start and goal are not connected (" << components->get_num_components() << " components), "
+                                << (params.edits_file.empty() ? "no path exists\n" : "replaying edits only\n");
+        }
+        if(connected){
             if(params.algo == BFS_ID || params.algo == ALL_ID) run_bfs(map, g, params.show_debug);
             if(params.algo == A_STAR_ID || params.algo == ALL_ID) run_astar(map, g, params.show_debug);
+            if(params.algo == DIJKSTRA_ID || params.algo == ALL_ID) run_grid_planner<Dijkstra>(map, g, DIJKSTRA_ID, "Dijkstra", params.show_debug);
+            if(params.algo == BUCKET_A_STAR_ID || params.algo == ALL_ID) run_grid_planner<BucketAStar>(map, g, BUCKET_A_STAR_ID, "Bucket A*", params.show_debug);
+            if(params.algo == JPS_ID || params.algo == ALL_ID) run_grid_planner<JPS>(map, g, JPS_ID, "JPS", params.show_debug);
+            if(params.algo == ADAPTIVE_A_STAR_ID || params.algo == ALL_ID) run_grid_planner<AdaptiveAStar>(map, g, ADAPTIVE_A_STAR_ID, "Adaptive A*", params.show_debug);
+            if(params.algo == ALT_A_STAR_ID || params.algo == ALL_ID) run_alt_a_star(map, g, cache, params.use_cache, params.show_debug);
+            if(params.algo == BI_BFS_ID || params.algo == ALL_ID) run_grid_planner<BidirectionalBFS>(map, g, BI_BFS_ID, "Bidirectional BFS", params.show_debug);
+            if(params.algo == BI_A_STAR_ID || params.algo == ALL_ID) run_grid_planner<BidirectionalAStar>(map, g, BI_A_STAR_ID, "Bidirectional A*", params.show_debug);
+            if(params.algo == ARA_STAR_ID || params.algo == ALL_ID) run_ara_star(map, g, params.show_debug);
+            if(params.algo == CH_ID || params.algo == ALL_ID) run_contraction_hierarchy(map, g, cache, params.use_cache, params.show_debug);
+            if(params.algo == PYRAMID_ID || params.algo == ALL_ID) run_pyramid_search(map, g, params.show_debug);
+            if(params.algo == COST_TO_GO_ID || params.algo == ALL_ID) run_cost_to_go(map, g, params.show_debug);
             if(params.algo == RRT_STAR_ID || params.algo == ALL_ID) run_rrt_star(map, g, params.max_iter, params.show_debug);
-            //if(params.algo == "d-lite" || params.algo == ALL_ID) run_d_star_lite(map, g, params.show_debug);
-            if(!is_valid_algo(params.algo)) cout << "Unrecognized algorithm: " << params.algo << endl;
         }
+        // Last since replaying edits changes the map; each replaying planner
+        // starts from the map as loaded. The edits may connect start and
+        // goal, so these still run on a disconnected query when replaying.
+        if(valid && (connected || !params.edits_file.empty())){
+            bool replayed = false;
+            if(params.algo == HPA_STAR_ID || params.algo == ALL_ID){
+                run_hpa_star(map, g, params.edits_file, params.show_debug);
+                replayed = !params.edits_file.empty();
+            }
+            if(params.algo == D_STAR_LITE_ID || params.algo == ALL_ID){
+                if(replayed){
+                    map = load_map(cache, params);
+                    g = cache.get_graph(map);
+                    g.root = params.start;
+                    g.end = params.goal;
+                }
+                run_d_star_lite(map, g, params.edits_file, params.show_debug);
+            }
+        }
+        if(!is_valid_algo(params.algo)) cout << "Unrecognized algorithm: " << params.algo << endl;
     }
 }
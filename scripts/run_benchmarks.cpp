@@ -0,0 +1,244 @@
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <filesystem>
+#include <cstring>
+
+#include "map_data.hpp"
+#include "grid_graph.hpp"
+#include "cell_layout.hpp"
+#include "bfs.hpp"
+#include "a_star.hpp"
+#include "dijkstra.hpp"
+#include "jps.hpp"
+#include "bidirectional_search.hpp"
+#include "landmarks.hpp"
+#include "ara_star.hpp"
+#include "contraction_hierarchy.hpp"
+#include "hpa_star.hpp"
+#include "pyramid_search.hpp"
+#include "cost_to_go.hpp"
+#include "d_star_lite.hpp"
+
+using namespace std::chrono;
+namespace fs = std::filesystem;
+
+struct Parameters{
+    string maps_dir = "resources/maps";
+    vector<int> sizes = {256, 512};
+    int repeats = 3, inflate_size = 3;
+    int timeout = 600000; // in milliseconds
+    bool get_help = false, kill_script = false;
+};
+
+struct Query{
+    string name;
+    Map map;
+    cell start, goal;
+};
+
+void print_help_menu(){
+    cout << "Description: Benchmark grid planners with the compiled cell layout (" << CellLayout::name() << ").\n";
+    cout << "options: \n";
+    cout << "   -h, --help                        Show this help message and exit.\n";
+    cout << "   -m MAPS_DIR, --maps-dir MAPS_DIR  Directory of map yaml files (Default: resources/maps).\n";
+    cout << "   -n SIZE, --size SIZE              Add a synthetic SIZE x SIZE map (Default: 256 and 512).\n";
+    cout << "   -r REPEATS, --repeats REPEATS     Number of runs per planner (Default: 3).\n";
+    cout << "   -t TIMEOUT, --timeout TIMEOUT     Set timeout limit per run (Default: 600000 ms).\n";
+}
+
+Parameters get_params(int argc, char* argv[]){
+    Parameters params;
+    bool custom_sizes = false;
+    for(int i = 1; i < argc; i++){
+        if(i+1 >= argc && strcmp(argv[i], "-h") != 0 && strcmp(argv[i], "--help") != 0){
+            cout << "Missing value for " << argv[i] << endl;
+            params.kill_script = true;
+            break;
+        }
+        try{
+            if(strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "--maps-dir") == 0) params.maps_dir = argv[++i];
+            else if(strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--size") == 0){
+                if(!custom_sizes) params.sizes.clear();
+                custom_sizes = true;
+                params.sizes.push_back(std::stoi(argv[++i]));
+            }
+            else if(strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "--repeats") == 0) params.repeats = std::stoi(argv[++i]);
+            else if(strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--timeout") == 0) params.timeout = std::stoi(argv[++i]);
+            else if(strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0){
+                params.get_help = true;
+                break;
+            }
+            else{
+                cout << "Unrecognized command: " << argv[i] << endl;
+                params.kill_script = true;
+                break;
+            }
+        }
+        catch(std::invalid_argument e){
+            cout << "Could not convert \"" << argv[i] << "\" value to integer." << endl;
+            params.kill_script = true;
+            break;
+        }
+    }
+    return params;
+}
+
+// Start at the first cell of the largest open region and end at the cell
+// furthest from it (in moves), so map queries are long and reachable
+pair<cell, cell> get_query_cells(const Map& map){
+    GridGraph g(map);
+    vector<int> hops(map.px_width*map.px_height, -1);
+    pair<cell, cell> best = {{-1, -1}, {-1, -1}};
+    int best_size = 0;
+    for(int row = 0; row < map.px_height; row++){
+        for(int col = 0; col < map.px_width; col++){
+            if(!g.is_node_valid({col, row}) || hops[row*map.px_width + col] >= 0) continue;
+            vector<cell> q = {{col, row}};
+            hops[row*map.px_width + col] = 0;
+            cell furthest = q[0];
+            for(size_t i = 0; i < q.size(); i++){
+                cell curr = q[i];
+                int curr_hops = hops[curr.second*map.px_width + curr.first];
+                if(curr_hops > hops[furthest.second*map.px_width + furthest.first]) furthest = curr;
+                for(auto n: g.get_neighbors(curr)){
+                    int &n_hops = hops[n.first.second*map.px_width + n.first.first];
+                    if(n_hops < 0){
+                        n_hops = curr_hops + 1;
+                        q.push_back(n.first);
+                    }
+                }
+            }
+            if((int)q.size() > best_size){
+                best_size = q.size();
+                best = {q[0], furthest};
+            }
+        }
+    }
+    return best;
+}
+
+// Open floor with a border and randomly placed rectangular obstacles
+Map get_synthetic_map(int size){
+    Map map;
+    map.px_width = size;
+    map.px_height = size;
+    map.resolution = 0.05;
+    map.m_width = size*map.resolution;
+    map.m_height = size*map.resolution;
+    map.boundaries = OccupancyGrid(size, size, MapData::OPEN_SPACE_INT);
+    srand(size);
+    for(int k = 0; k < size/4; k++){
+        int w = 2 + rand()%(size/16 + 1), h = 2 + rand()%(size/16 + 1);
+        int col = rand()%(size-w), row = rand()%(size-h);
+        map.boundaries.view(col, row, w, h).fill(MapData::OBSTACLE_INT);
+    }
+    for(int i = 0; i < size; i++){
+        map.boundaries[0][i] = map.boundaries[size-1][i] = MapData::OBSTACLE_INT;
+        map.boundaries[i][0] = map.boundaries[i][size-1] = MapData::OBSTACLE_INT;
+    }
+    // Keep start and goal corners clear
+    map.boundaries.view(1, 1, 4, 4).fill(MapData::OPEN_SPACE_INT);
+    map.boundaries.view(size-5, size-5, 4, 4).fill(MapData::OPEN_SPACE_INT);
+    return map;
+}
+
+// make_planner(g) builds the planner inside the timed region (or returns a
+// reference to one built beforehand)
+template<typename MakePlanner>
+void run_planner(string algo, Query& q, int repeats, int timeout, MakePlanner make_planner){
+    GridGraph g(q.map);
+    g.root = q.start;
+    g.end = q.goal;
+    vector<float> times;
+    float dist = 0;
+    for(int r = 0; r < repeats; r++){
+        auto start_time = high_resolution_clock::now();
+        auto&& planner = make_planner(g);
+        planner.solve(g.root, g.end, timeout);
+        auto end_time = high_resolution_clock::now();
+        times.push_back(duration_cast<microseconds>(end_time-start_time).count()/1000.0);
+        dist = planner.reconstruct_path(g.root, g.end).second;
+    }
+    std::sort(times.begin(), times.end());
+    cout << std::left << std::setw(12) << CellLayout::name() << std::setw(24) << q.name << std::setw(16) << algo;
+    cout << std::right << std::setw(12) << std::fixed << std::setprecision(2) << times[times.size()/2] << " ms";
+    cout << std::setw(12) << std::setprecision(1) << dist << endl;
+}
+
+template<typename Planner>
+void run_planner(string algo, Query& q, int repeats, int timeout){
+    run_planner(algo, q, repeats, timeout, [](const GridGraph& g){ return Planner(g); });
+}
+
+int main(int argc, char* argv[]){
+    auto params = get_params(argc, argv);
+    if(params.get_help) print_help_menu();
+    if(params.get_help || params.kill_script) return 0;
+
+    vector<Query> queries;
+    if(fs::is_directory(params.maps_dir)){
+        for(auto& entry: fs::directory_iterator(params.maps_dir)){
+            if(entry.path().extension() != ".yaml") continue;
+            Query q;
+            q.name = entry.path().stem().string();
+            q.map = MapData::get_map(entry.path().string());
+            q.map.boundaries = MapData::inflate_boundaries(q.map, params.inflate_size);
+            auto query_cells = get_query_cells(q.map);
+            q.start = query_cells.first;
+            q.goal = query_cells.second;
+            queries.push_back(std::move(q));
+        }
+    }
+    else cout << "Could not find maps directory: " << params.maps_dir << endl;
+    for(int size: params.sizes){
+        Query q;
+        q.name = "synthetic_" + std::to_string(size);
+        q.map = get_synthetic_map(size);
+        q.start = {2, 2};
+        q.goal = {size-3, size-3};
+        queries.push_back(std::move(q));
+    }
+
+    cout << std::left << std::setw(12) << "Layout" << std::setw(24) << "Map" << std::setw(16) << "Algo";
+    cout << std::right << std::setw(15) << "Median" << std::setw(12) << "Distance" << endl;
+    for(auto& q: queries){
+        run_planner<BFS>("bfs", q, params.repeats, params.timeout);
+        run_planner<AStar>("a-star", q, params.repeats, params.timeout);
+        run_planner<Dijkstra>("dijkstra", q, params.repeats, params.timeout);
+        run_planner<BucketAStar>("bucket-a-star", q, params.repeats, params.timeout);
+        run_planner<JPS>("jps", q, params.repeats, params.timeout);
+        // Landmarks are preprocessing, so only queries are timed
+        auto landmarks = make_shared<const LandmarkTable>(GridGraph(q.map), LandmarkTable::DEFAULT_LANDMARKS);
+        run_planner("alt-a-star", q, params.repeats, params.timeout, [&](const GridGraph& g){
+            return ALTAStar(g, LandmarkHeuristic(landmarks));
+        });
+        run_planner<BidirectionalBFS>("bi-bfs", q, params.repeats, params.timeout);
+        run_planner<BidirectionalAStar>("bi-a-star", q, params.repeats, params.timeout);
+        run_planner<ARAStar>("ara-star", q, params.repeats, params.timeout);
+        auto ch = make_shared<const ContractionHierarchy>(GridGraph(q.map));
+        run_planner("ch", q, params.repeats, params.timeout, [&](const GridGraph& g){
+            return CHSearch(g, ch);
+        });
+        // Cluster abstraction is preprocessing too; an empty edit list only rebinds it
+        auto hpa_graph = GridGraph(q.map);
+        auto hpa = HPAStar(hpa_graph);
+        run_planner("hpa-star", q, params.repeats, params.timeout, [&](const GridGraph& g) -> HPAStar& {
+            hpa.update_graph(g, {});
+            return hpa;
+        });
+        // So is the occupancy pyramid
+        auto pyramid_graph = GridGraph(q.map);
+        auto pyramid = PyramidSearch(pyramid_graph);
+        run_planner("pyramid", q, params.repeats, params.timeout, [&](const GridGraph& g) -> PyramidSearch& {
+            return pyramid;
+        });
+        // And the cost-to-go field of the goal, which the first call caches
+        auto cost_to_go = make_shared<CostToGoCache>();
+        cost_to_go->get_field(GridGraph(q.map), q.goal);
+        run_planner("cost-to-go", q, params.repeats, params.timeout, [&](const GridGraph& g){
+            return CostToGoSearch(g, cost_to_go);
+        });
+        run_planner<DStarLite>("d-star-lite", q, params.repeats, params.timeout);
+    }
+}
@@ -5,9 +5,25 @@
 //#include <gtest/gtest.h>
 
 #include "map_data.hpp" 
+#include "grid_graph.hpp"
+#include "map_cache.hpp"
+#include "layered_map.hpp"
+#include "free_bitmap.hpp"
+#include "cell_layout.hpp"
 #include "bfs.hpp"
 #include "a_star.hpp"
-//#include "d_star_lite.hpp"
+#include "dijkstra.hpp"
+#include "jps.hpp"
+#include "adaptive_a_star.hpp"
+#include "landmarks.hpp"
+#include "bidirectional_search.hpp"
+#include "ara_star.hpp"
+#include "contraction_hierarchy.hpp"
+#include "hpa_star.hpp"
+#include "pyramid_search.hpp"
+#include "cost_to_go.hpp"
+#include "components.hpp"
+#include "d_star_lite.hpp"
 #include "rrt_star.hpp"
 #include "gen_ros_map.hpp"
 
@@ -41,8 +57,7 @@ Map get_simple_map(){
         {-1,0,0,0,0,0,0,0,0,-1,0,-1,0,0,-1,0,0,0,0,-1},
         {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,0,-1,-1,-1,-1,-1,-1,-1,-1,-1},
     };
-    map.boundaries = new int*[map.px_height];
-    for(int k = 0; k < map.px_height; k++) map.boundaries[k] = new int[map.px_width];
+    map.boundaries = OccupancyGrid(map.px_width, map.px_height);
     for(int row = 0; row < map.px_height; row++){
         for(int col = 0; col < map.px_width; col++){
             map.boundaries[row][col] = temp[row][col];
@@ -211,7 +226,35 @@ void test_data_extraction(){
     catch(std::exception e){
         cout << "failed, " << e.what() << endl;
     }
-    cout << "File Format Tests Passed: " << passed_count << "/3\n\n";
+
+    // Check that the map cache round trips the inflated map and its graph,
+    // and is not used once the PGM changes
+    cout << "\tMap Cache Test: ";
+    {
+        MapCache cache;
+        Map built = cache.load_map(yaml_path.string(), 3);
+        Map cached = cache.load_map(yaml_path.string(), 3);
+        bool cache_matches = cache.is_open() && !cached.boundaries.owns_data() &&
+                             cached.px_width == built.px_width && cached.px_height == built.px_height;
+        GridGraph cached_graph = cache.get_graph(cached), built_graph(built);
+        for(int row = 0; cache_matches && row < built.px_height; row++){
+            for(int col = 0; col < built.px_width; col++){
+                if(cached.boundaries[row][col] != built.boundaries[row][col] ||
+                   cached_graph.get_neighbor_mask({col, row}) != built_graph.get_neighbor_mask({col, row})){
+                    cache_matches = false;
+                }
+            }
+        }
+        original.boundaries[0][0] = original.boundaries[0][0] == MapData::OPEN_SPACE_INT ? MapData::OBSTACLE_INT : MapData::OPEN_SPACE_INT;
+        GenerateMap::generate_map_pgm(original, tmp_path, title);
+        MapCache stale_cache;
+        if(cache_matches && !stale_cache.open(yaml_path.string(), 3)){
+            cout << "passed\n";
+            passed_count++;
+        }
+        else cout << "failed\n";
+    }
+    cout << "File Format Tests Passed: " << passed_count << "/4\n\n";
     fs::remove_all(tmp_path);
     //MapData::print_boundary(original.boundaries, original.px_width, original.px_height);
     //MapData::print_boundary(extracted_map.boundaries, extracted_map.px_width, extracted_map.px_height);
@@ -271,7 +314,7 @@ void test_map_data(){
     
     // Test copy boundaries function
     vector<cell> incorrect_pixels;
-    int** copied_boundaries = MapData::copy_boundaries(map_data);
+    OccupancyGrid copied_boundaries = MapData::copy_boundaries(map_data);
     for(int r = 0; r < map_data.px_height; r++){
         for(int c = 0; c < map_data.px_width; c++){
             if(map_data.boundaries[r][c] != copied_boundaries[r][c]){
@@ -290,6 +333,29 @@ void test_map_data(){
         passed_count++;
     }
 
+    // Test wrapping an external buffer and writing through a sub-region view
+    vector<int8_t> buffer(map_data.px_width*map_data.px_height);
+    for(int r = 0; r < map_data.px_height; r++){
+        for(int c = 0; c < map_data.px_width; c++) buffer[r*map_data.px_width + c] = map_data.boundaries[r][c];
+    }
+    OccupancyGrid wrapped(buffer.data(), map_data.px_width, map_data.px_height);
+    GridView region = wrapped.view(2, 3, 4, 2);
+    region.fill(MapData::PATH_INT);
+    bool wrap_correct = !wrapped.owns_data() && wrapped[5][7] == map_data.boundaries[5][7];
+    for(int r = 0; r < map_data.px_height; r++){
+        for(int c = 0; c < map_data.px_width; c++){
+            bool in_region = c >= 2 && c < 6 && r >= 3 && r < 5;
+            int expected = in_region ? MapData::PATH_INT : map_data.boundaries[r][c];
+            if(buffer[r*map_data.px_width + c] != expected) wrap_correct = false;
+        }
+    }
+    cout << "\tWrapped Grid View Test: ";
+    if(wrap_correct){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, view writes did not match the wrapped buffer\n";
+
     // Check get graph function
     vector<pair<cell,cell>> missing_edges;
     vector<pair<cell,cell>> incorrect_edges;
@@ -340,9 +406,8 @@ void test_map_data(){
         {{16,7}, {{16,6}, {17,6}, {17,7}}}, 
         {{17,7}, {{16,6}, {17,6}, {16,7}}}
     };
-    for(auto actual_vals : graph.g){
-        cell a_node = actual_vals.first;
-        vector<iw_cell> a_edges = actual_vals.second;
+    for(auto a_node : graph.get_nodes()){
+        auto a_edges = graph.get_edges(a_node);
         if(expected_tree.find(a_node) == expected_tree.end()) incorrect_nodes.push_back(a_node);
         else{
             vector<cell> expected_edges = expected_tree[a_node];
@@ -361,9 +426,9 @@ void test_map_data(){
     for(auto expected_vals : expected_tree){
         cell e_node = expected_vals.first;
         vector<cell> e_edges = expected_vals.second;
-        if(graph.g.find(e_node) == graph.g.end()) missing_nodes.push_back(e_node);
+        if(!graph.is_node_valid(e_node)) missing_nodes.push_back(e_node);
         else{
-            auto actual_edges = graph.g[e_node];
+            auto actual_edges = graph.get_edges(e_node);
             for(int j = 0; j < e_edges.size(); j++){
                 auto expected_edge = e_edges[j];
                 for(int i = 0; i < actual_edges.size(); i++){
@@ -403,7 +468,217 @@ void test_map_data(){
             cout << "]\n";
         }
     }
-    cout << "Map Tests Passed: " << passed_count << "/3\n\n";
+
+    // Check implicit grid graph matches explicit graph
+    vector<cell> mismatched_nodes;
+    GridGraph grid_graph(map_data);
+    for(int row = -1; row <= map_data.px_height; row++){
+        for(int col = -1; col <= map_data.px_width; col++){
+            cell node = {col, row};
+            if(grid_graph.is_node_valid(node) != graph.is_node_valid(node)){
+                mismatched_nodes.push_back(node);
+                continue;
+            }
+            auto view_edges = grid_graph.get_neighbors(node);
+            auto graph_edges = graph.get_edges(node);
+            bool edges_match = view_edges.size() == graph_edges.size();
+            for(int i = 0; edges_match && i < view_edges.size(); i++){
+                if(view_edges.data[i] != graph_edges[i]) edges_match = false;
+            }
+            if(!edges_match) mismatched_nodes.push_back(node);
+        }
+    }
+    cout << "\tGrid Graph View Test: ";
+    if(mismatched_nodes.empty() && grid_graph.get_size() == graph.get_size() &&
+       grid_graph.get_nodes() == graph.get_nodes()){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else{
+        cout << "failed, \n\t\tMismatched nodes: [ ";
+        for(auto mn: mismatched_nodes) cout << "(" << mn.first << "," << mn.second << ") ";
+        cout << "]\n";
+    }
+
+    // Check bitmap neighbor masks against the occupancy grid on a map wider than a word
+    Map wide_map;
+    wide_map.px_width = 150;
+    wide_map.px_height = 7;
+    wide_map.boundaries = OccupancyGrid(wide_map.px_width, wide_map.px_height);
+    srand(7);
+    for(int r = 0; r < wide_map.px_height; r++){
+        for(int c = 0; c < wide_map.px_width; c++){
+            wide_map.boundaries[r][c] = rand()%4 == 0 ? MapData::OBSTACLE_INT : MapData::OPEN_SPACE_INT;
+        }
+    }
+    FreeBitmap bitmap(wide_map);
+    vector<cell> incorrect_masks;
+    vector<uint8_t> row_masks(wide_map.px_width);
+    for(int r = 0; r < wide_map.px_height; r++){
+        bitmap.row_neighbor_masks(r, row_masks.data());
+        for(int c = 0; c < wide_map.px_width; c++){
+            uint8_t expected = 0;
+            for(int d = 0; d < MAX_NEIGHBORS; d++){
+                int x = c + MapData::DIR_DX[d], y = r + MapData::DIR_DY[d];
+                if(x >= 0 && x < wide_map.px_width && y >= 0 && y < wide_map.px_height &&
+                   wide_map.boundaries[y][x] == MapData::OPEN_SPACE_INT) expected |= 1 << d;
+            }
+            bool free_matches = bitmap.is_free(c, r) == (wide_map.boundaries[r][c] == MapData::OPEN_SPACE_INT);
+            if(!free_matches || bitmap.neighbor_mask(c, r) != expected || row_masks[c] != expected){
+                incorrect_masks.push_back(cell{c, r});
+            }
+        }
+    }
+    cout << "\tFree Bitmap Mask Test: ";
+    if(incorrect_masks.empty()){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else{
+        cout << "failed, \n\t\tIncorrect masks: [ ";
+        for(auto im: incorrect_masks) cout << "(" << im.first << "," << im.second << ") ";
+        cout << "]\n";
+    }
+
+    // Check that cell ids are unique, in range and convert back to the same cell
+    CellLayout id_layout(37, 45);
+    vector<uint8_t> id_seen(id_layout.size(), 0);
+    vector<cell> incorrect_ids;
+    for(int r = 0; r < 45; r++){
+        for(int c = 0; c < 37; c++){
+            cell_id id = id_layout.to_id(cell{c, r});
+            if(!id.is_valid() || (int)id.v >= id_layout.size() || id_seen[id.v] || id_layout.to_cell(id) != cell{c, r}){
+                incorrect_ids.push_back(cell{c, r});
+            }
+            else id_seen[id.v] = 1;
+        }
+    }
+    cout << "\tCell Id Round Trip Test: ";
+    if(incorrect_ids.empty()){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else{
+        cout << "failed, \n\t\tIncorrect ids: [ ";
+        for(auto ic: incorrect_ids) cout << "(" << ic.first << "," << ic.second << ") ";
+        cout << "]\n";
+    }
+
+    // Patch a graph from small edits and compare it with a graph built from scratch
+    GridGraph patched_graph(wide_map);
+    for(int k = 0; k < 20; k++){
+        cell pt = {(k*37 + 11)%wide_map.px_width, (k*5 + 3)%wide_map.px_height};
+        wide_map.boundaries[pt.second][pt.first] = k%2 ? MapData::OBSTACLE_INT : MapData::OPEN_SPACE_INT;
+        MapData::inflate_point(wide_map, pt, 3);
+        MapData::mark_dirty(wide_map, MapData::point_rect(wide_map, pt, 3));
+        if(k%5 == 4) patched_graph.update(wide_map);
+    }
+    GridGraph rebuilt_graph(wide_map);
+    vector<cell> incorrect_patches;
+    for(int r = 0; r < wide_map.px_height; r++){
+        for(int c = 0; c < wide_map.px_width; c++){
+            if(patched_graph.is_node_valid({c, r}) != rebuilt_graph.is_node_valid({c, r}) ||
+               patched_graph.get_neighbor_mask({c, r}) != rebuilt_graph.get_neighbor_mask({c, r})){
+                incorrect_patches.push_back(cell{c, r});
+            }
+        }
+    }
+    cout << "\tIncremental Graph Update Test: ";
+    if(incorrect_patches.empty() && patched_graph.get_size() == rebuilt_graph.get_size() && !patched_graph.update(wide_map)){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else{
+        cout << "failed, \n\t\tIncorrect cells: [ ";
+        for(auto ip: incorrect_patches) cout << "(" << ip.first << "," << ip.second << ") ";
+        cout << "]\n\t\tNodes (patched, rebuilt): " << patched_graph.get_size() << ", " << rebuilt_graph.get_size() << "\n";
+    }
+
+    // Label the components of the simple map, open the bottom pocket, then
+    // wall off the left room, comparing the patched labels with labels built
+    // from scratch after each edit
+    Map pocket_map = get_simple_map();
+    GridGraph pocket_graph(pocket_map);
+    ComponentLabels components(pocket_graph);
+    cell room = {3, 3}, pocket = {10, 8};
+    bool labels_correct = components.get_num_components() == 3 && components.connected(room, {16, 7}) &&
+                          !components.connected(room, pocket) && !components.connected(room, {18, 0}) &&
+                          !components.connected(room, {0, 0});
+    pocket_map.boundaries[7][10] = MapData::OPEN_SPACE_INT;
+    MapData::mark_dirty(pocket_map, {10, 7, 1, 1});
+    vector<CellRect> pocket_edits;
+    MapData::get_dirty_rects(pocket_map, components.get_map_version(), pocket_edits);
+    pocket_graph.update(pocket_map);
+    components.update(pocket_graph, pocket_edits);
+    ComponentLabels relabeled(pocket_graph);
+    labels_correct = labels_correct && components.connected(room, pocket) &&
+                     components.get_num_components() == relabeled.get_num_components();
+    for(int r = 0; r < pocket_map.px_height; r++){
+        for(int c = 0; c < pocket_map.px_width; c++){
+            if(components.connected(room, {c, r}) != relabeled.connected(room, {c, r})) labels_correct = false;
+        }
+    }
+    cout << "\tConnected Components Test: ";
+    if(labels_correct){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, " << components.get_num_components() << " components (expected 3, then " << relabeled.get_num_components() << " after the edit)\n";
+
+    // Column 6 is the only way out of the left room, so closing it splits
+    // the room off again
+    for(int r = 5; r <= 8; r++) pocket_map.boundaries[r][6] = MapData::OBSTACLE_INT;
+    MapData::mark_dirty(pocket_map, {6, 5, 1, 4});
+    MapData::get_dirty_rects(pocket_map, components.get_map_version(), pocket_edits);
+    pocket_graph.update(pocket_map);
+    components.update(pocket_graph, pocket_edits);
+    ComponentLabels split(pocket_graph);
+    bool split_correct = !components.connected(room, {16, 7}) && components.connected({16, 7}, pocket) &&
+                         components.get_num_components() == 3 && split.get_num_components() == 3;
+    for(int r = 0; r < pocket_map.px_height; r++){
+        for(int c = 0; c < pocket_map.px_width; c++){
+            if(components.connected(room, {c, r}) != split.connected(room, {c, r}) ||
+               components.connected({16, 7}, {c, r}) != split.connected({16, 7}, {c, r})) split_correct = false;
+        }
+    }
+    cout << "\tConnected Components Split Test: ";
+    if(split_correct){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, " << components.get_num_components() << " components after the split (fresh labels have " << split.get_num_components() << ")\n";
+
+    // Check that overlays compose to the same map as drawing the result directly
+    Map overlay_base = get_simple_map();
+    vector<cell> overlay_path = {{3,3}, {4,4}, {5,5}, {6,5}, {7,5}};
+    vector<cell> overlay_travelled = {{3,4}, {4,3}, {5,4}, {6,6}, {19,9}};
+    LayeredMap layered(overlay_base);
+    layered.add_cells(layered.add_layer(), overlay_travelled, MapData::TRAVELLED_INT);
+    layered.add_path(layered.add_layer(), overlay_path, MapData::PATH_INT, MapData::PATH_SIZE);
+    int point_layer = layered.add_layer();
+    layered.add_point(point_layer, {3,3}, MapData::NAV_POINT_INT, MapData::POINT_SIZE);
+    layered.add_point(point_layer, {7,5}, MapData::NAV_POINT_INT, MapData::POINT_SIZE);
+    Map composed = layered.compose();
+    Map drawn = MapData::debug_map(overlay_base, overlay_path, overlay_travelled, {3,3}, {7,5});
+    vector<cell> incorrect_overlays;
+    for(int r = 0; r < drawn.px_height; r++){
+        for(int c = 0; c < drawn.px_width; c++){
+            if(composed.boundaries[r][c] != drawn.boundaries[r][c] || layered.value_at(c, r) != drawn.boundaries[r][c]){
+                incorrect_overlays.push_back(cell{c, r});
+            }
+        }
+    }
+    cout << "\tLayered Map Overlay Test: ";
+    if(incorrect_overlays.empty()){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else{
+        cout << "failed, \n\t\tIncorrect cells: [ ";
+        for(auto io: incorrect_overlays) cout << "(" << io.first << "," << io.second << ") ";
+        cout << "]\n";
+    }
+    cout << "Map Tests Passed: " << passed_count << "/11\n\n";
 }
 
 /*
@@ -488,6 +763,75 @@ float path_rmse_error(vector<cell> expected, vector<cell> actual){
     return sqrt(err);
 }
 
+// Start and goal of the planner tests on the simple map, and the shortest
+// path between them
+const cell SIMPLE_ROOT = {3, 3}, SIMPLE_END = {16, 7};
+const vector<cell> SIMPLE_PATH = {{3,3}, {4,3}, {5,4}, {6,5}, {7,5}, {8,5},
+                                  {9,4}, {10,3}, {11,3}, {12,3}, {13,3},
+                                  {14,4}, {15,5}, {15,6}, {16,7}};
+
+// Runs planner from g.root to g.end and returns how long it took
+template<typename Planner>
+milliseconds timed_solve(Planner& planner, const PlanningGraph& g){
+    auto start_time = get_time("Start Time"); 
+    planner.solve(g.root, g.end, COMPUTE_TIMEOUT);
+    auto end_time = get_time("End Time"); 
+    return duration_cast<milliseconds>(end_time - start_time);
+}
+
+float get_a_star_dist(const PlanningGraph& g, cell sp, cell ep){
+    auto as = AStar(g);
+    as.solve(sp, ep, COMPUTE_TIMEOUT);
+    return as.reconstruct_path(sp, ep).second;
+}
+
+void test_speed(milliseconds duration, int duration_limit, int &pass_count){
+    if(duration.count() < duration_limit){
+        cout << "passed\n";
+        pass_count++;
+    } 
+    else cout << "failed, " << duration.count() << " ms > " << duration_limit << " ms (time threshold)\n";
+}
+
+// True if path goes from sp to ep in single moves over valid cells and its
+// moves add up to dist
+bool is_valid_path(const PlanningGraph& g, const vector<cell>& path, cell sp, cell ep, float dist){
+    if(path.empty() || path.front() != sp || path.back() != ep) return false;
+    float path_cost = 0;
+    for(size_t i = 1; i < path.size(); i++){
+        int dx = std::abs(path[i].first - path[i-1].first), dy = std::abs(path[i].second - path[i-1].second);
+        if(std::max(dx, dy) != 1 || !g.is_node_valid(path[i])) return false;
+        path_cost += OctileHeuristic::cost<float>(path[i-1], path[i]);
+    }
+    return path_cost == dist;
+}
+
+void test_valid_path(const PlanningGraph& g, const vector<cell>& path, float dist, int &pass_count){
+    if(is_valid_path(g, path, g.root, g.end, dist)){
+        cout << "passed\n";
+        pass_count++;
+    }
+    else cout << "failed, path is not connected or does not cost " << dist << endl;
+}
+
+void test_same_dist(float dist, float expected_dist, int &pass_count){
+    if(dist == expected_dist){
+        cout << "passed\n";
+        pass_count++;
+    }
+    else cout << "failed, distance is " << dist << " (A* distance is " << expected_dist << ")\n";
+}
+
+void test_path_rmse(const vector<cell>& path, int &pass_count){
+    float path_err_thresh = 2.5;
+    float rmse_err = path_rmse_error(SIMPLE_PATH, path);
+    if(rmse_err <= path_err_thresh){
+        cout << "passed\n";
+        pass_count++;
+    }
+    else cout << "failed, RMSE for path is " << rmse_err << endl;
+}
+
 /*
 BFS (Using Simple Data)
     Path Generated between start and goal
@@ -610,12 +954,737 @@ void test_a_star_simple(){
 }
 
 /*
-D* (Using Simple Data)
+Dijkstra (Using Simple Data)
+    Algorithm Completes
+    Path Generated between start and goal
+    Bucket A* finds a path of the same length
+    Bucket A* rejects a heuristic weight other than 1
+*/
+void test_dijkstra_simple(){
+    auto m = get_simple_map();
+    auto g = MapData::get_graph_from_map(m);
+
+    g.root = {3, 3};
+    g.end = {16, 7};
+    auto dijkstra = Dijkstra(g);
+
+    auto start_time = get_time("Start Time"); 
+    dijkstra.solve(g.root, g.end, COMPUTE_TIMEOUT);
+    auto end_time = get_time("End Time"); 
+    auto duration = duration_cast<milliseconds>(end_time- start_time);
+
+    auto results = dijkstra.reconstruct_path(g.root, g.end);
+    vector<cell> path = results.first;
+    float dist = results.second;
+
+    auto bucket_a_star = BucketAStar(g);
+    bucket_a_star.solve(g.root, g.end, COMPUTE_TIMEOUT);
+    float heuristic_dist = bucket_a_star.reconstruct_path(g.root, g.end).second;
+
+    // Test component
+    int duration_limit = 10;
+    float path_err_thresh = 2.5;
+    int passed_count = 0;
+    cout << "DIJKSTRA TESTS\n";
+    cout << "\tTest Start Point: ";
+    test_valid_node(g, g.root, passed_count);
+    cout << "\tTest End Point: ";
+    test_valid_node(g, g.end, passed_count);
+    cout << "\tTest Speed: ";
+    if(duration.count() < duration_limit){
+        cout << "passed\n";
+        passed_count++;
+    } 
+    else cout << "failed, " << duration.count() << " ms > " << duration_limit << " ms (time threshold)\n";
+    vector<cell> expected_path = {{3,3}, {4,3}, {5,4}, {6,5}, {7,5}, {8,5}, 
+                                  {9,4}, {10,3}, {11,3}, {12,3}, {13,3}, 
+                                  {14,4}, {15,5}, {15,6}, {16,7}};
+    int dist_limit = 25;
+    cout << "\tTest Path: ";
+    float rmse_err = path_rmse_error(expected_path, path);
+    if(rmse_err <= path_err_thresh){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, RMSE for path is " << rmse_err << endl;
+    cout << "\tTest Distance: ";
+    if(dist <= dist_limit){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, distance is greater than " << dist_limit << endl;
+    cout << "\tTest Bucket A* Distance: ";
+    if(heuristic_dist == dist){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, distance is " << heuristic_dist << " (expected " << dist << ")\n";
+    cout << "\tTest Weighted Bucket A* Rejected: ";
+    try{
+        BucketAStar(g, 1.5);
+        cout << "failed, weight 1.5 was accepted\n";
+    }
+    catch(const std::invalid_argument& e){
+        cout << "passed\n";
+        passed_count++;
+    }
+
+    cout << "\tTest Invalid Point: ";
+    test_invalid_node(g, {0,0}, passed_count);
+    cout << "Dijkstra Tests Passed: " << passed_count << "/8\n\n";
+}
+
+/*
+JPS (Using Simple Data)
+    Algorithm Completes
+    Path Generated between start and goal
+    Path costs the same as the A* path
+    Path after an edit costs the same as the A* path
+*/
+void test_jps_simple(){
+    auto m = get_simple_map();
+    auto g = MapData::get_graph_from_map(m);
+    g.root = SIMPLE_ROOT;
+    g.end = SIMPLE_END;
+    auto jps = JPS(g);
+    auto duration = timed_solve(jps, g);
+    auto results = jps.reconstruct_path(g.root, g.end);
+
+    // Test component
+    int passed_count = 0;
+    cout << "JPS TESTS\n";
+    cout << "\tTest Start Point: ";
+    test_valid_node(g, g.root, passed_count);
+    cout << "\tTest End Point: ";
+    test_valid_node(g, g.end, passed_count);
+    cout << "\tTest Speed: ";
+    test_speed(duration, 10, passed_count);
+    cout << "\tTest Path: ";
+    test_path_rmse(results.first, passed_count);
+    cout << "\tTest Same Distance as A*: ";
+    test_same_dist(results.second, get_a_star_dist(g, g.root, g.end), passed_count);
+
+    cout << "\tTest Invalid Point: ";
+    test_invalid_node(g, {0,0}, passed_count);
+
+    // Close the gap in the wall the path runs through; the jump table of
+    // the edited grid has to be rebuilt for the detour
+    cout << "\tTest Map Change: ";
+    auto grid = GridGraph(m);
+    grid.root = SIMPLE_ROOT;
+    grid.end = SIMPLE_END;
+    m.boundaries[5][6] = OBSTACLE_INT;
+    MapData::mark_dirty(m, MapData::point_rect(m, {6, 5}, 1));
+    grid.update(m);
+    auto edited = JPS(grid);
+    edited.solve(grid.root, grid.end, COMPUTE_TIMEOUT);
+    auto detour = edited.reconstruct_path(grid.root, grid.end);
+    float detour_dist = get_a_star_dist(grid, grid.root, grid.end);
+    if(detour.second == detour_dist && detour.second > results.second && is_valid_path(grid, detour.first, grid.root, grid.end, detour.second)){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, distance after the edit is " << detour.second << " (A* distance is " << detour_dist << ")\n";
+    cout << "JPS Tests Passed: " << passed_count << "/7\n\n";
+}
+
+/*
+Adaptive A* (Using Simple Data)
+    Path Generated between start and goal
+    Path costs the same as the A* path
+    Repeated queries to the same goal expand fewer cells
+    Learned values are dropped when the map changes
+    Invalid goal is rejected without a search
+*/
+void test_adaptive_a_star_simple(){
+    auto m = get_simple_map();
+    auto g = GridGraph(m);
+    g.root = SIMPLE_ROOT;
+    g.end = SIMPLE_END;
+    AdaptiveAStar::clear_heuristics();
+
+    auto cold = AdaptiveAStar(g);
+    auto duration = timed_solve(cold, g);
+    auto results = cold.reconstruct_path(g.root, g.end);
+    float dist = results.second;
+
+    auto warm = AdaptiveAStar(g);
+    warm.solve({1, 8}, g.end, COMPUTE_TIMEOUT);
+    auto again = AdaptiveAStar(g);
+    again.solve(g.root, g.end, COMPUTE_TIMEOUT);
+    float a_star_dist = get_a_star_dist(g, g.root, g.end);
+
+    // Test component
+    int passed_count = 0;
+    cout << "ADAPTIVE A-STAR TESTS\n";
+    cout << "\tTest Speed: ";
+    test_speed(duration, 10, passed_count);
+    cout << "\tTest Path: ";
+    test_path_rmse(results.first, passed_count);
+    cout << "\tTest Same Distance as A*: ";
+    float again_dist = again.reconstruct_path(g.root, g.end).second;
+    if(dist == a_star_dist && again_dist == a_star_dist && warm.goal_reached){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, distances are " << dist << " and " << again_dist << " (A* distance is " << a_star_dist << ")\n";
+    cout << "\tTest Fewer Expansions: ";
+    size_t cold_count = cold.get_travelled_nodes().size(), again_count = again.get_travelled_nodes().size();
+    if(again_count < cold_count){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, " << again_count << " cells seen after learning (" << cold_count << " before)\n";
+    cout << "\tTest Map Change: ";
+    m.boundaries[1][18] = OBSTACLE_INT;
+    MapData::mark_dirty(m, MapData::point_rect(m, {18, 1}, 1));
+    g.update(m);
+    auto changed = AdaptiveAStar(g);
+    changed.solve(g.root, g.end, COMPUTE_TIMEOUT);
+    if(changed.get_travelled_nodes().size() == cold_count){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, learned values were reused after the map changed\n";
+    cout << "\tTest Invalid Goal: ";
+    auto invalid = AdaptiveAStar(g);
+    invalid.solve(g.root, {0,0}, COMPUTE_TIMEOUT);
+    if(!invalid.goal_reached && invalid.get_travelled_nodes().empty()){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, searched " << invalid.get_travelled_nodes().size() << " cells for a blocked goal\n";
+    cout << "Adaptive A-Star Tests Passed: " << passed_count << "/6\n\n";
+}
+
+/*
+ALT A* (Using Simple Data)
+    Path Generated between start and goal
+    Landmark bound never overestimates, over many pairs of cells
+    Path costs the same as the A* path
+    Serialized landmark table gives the same bounds
+    Planners share the table until the map is edited
+*/
+void test_alt_a_star_simple(){
+    auto m = get_simple_map();
+    auto g = GridGraph(m);
+    g.root = SIMPLE_ROOT;
+    g.end = SIMPLE_END;
+    auto table = make_shared<const LandmarkTable>(g, 4);
+    auto alt = ALTAStar(g, LandmarkHeuristic(table));
+    auto duration = timed_solve(alt, g);
+    auto results = alt.reconstruct_path(g.root, g.end);
+    float a_star_dist = get_a_star_dist(g, g.root, g.end);
+
+    // Test component
+    int passed_count = 0;
+    cout << "ALT A-STAR TESTS\n";
+    cout << "\tTest Speed: ";
+    test_speed(duration, 10, passed_count);
+    cout << "\tTest Path: ";
+    test_path_rmse(results.first, passed_count);
+    cout << "\tTest Admissible Bound: ";
+    // Every pair of free cells, not only the test query
+    auto nodes = g.get_nodes();
+    int bound = table->lower_bound(g.root, g.end);
+    bool admissible = table->get_landmarks().size() == 4 && bound > 0;
+    for(size_t i = 0; admissible && i < nodes.size(); i += 5){
+        for(size_t j = 0; admissible && j < nodes.size(); j += 11){
+            float d = get_a_star_dist(g, nodes[i], nodes[j]);
+            admissible = d == std::numeric_limits<float>::infinity() || table->lower_bound(nodes[i], nodes[j]) <= d;
+        }
+    }
+    if(admissible){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, a bound is above the A* distance (bound of the test query is " << bound << ")\n";
+    cout << "\tTest Same Distance as A*: ";
+    test_same_dist(results.second, a_star_dist, passed_count);
+    cout << "\tTest Serialization: ";
+    auto data = table->serialize();
+    auto loaded = LandmarkTable::deserialize(data.data(), data.size(), g);
+    if(loaded && loaded->get_landmarks() == table->get_landmarks() && loaded->lower_bound(g.root, g.end) == bound &&
+       !LandmarkTable::deserialize(data.data(), data.size()-1, g)){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, loaded table does not match\n";
+    cout << "\tTest Shared Table: ";
+    auto shared = LandmarkTable::get_landmark_table(g, 4);
+    bool reused = shared == LandmarkTable::get_landmark_table(g, 4);
+    m.boundaries[5][6] = OBSTACLE_INT;
+    MapData::mark_dirty(m, MapData::point_rect(m, {6, 5}, 1));
+    g.update(m);
+    if(reused && LandmarkTable::get_landmark_table(g, 4) != shared){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, table was " << (reused ? "not rebuilt after an edit\n" : "rebuilt without an edit\n");
+    cout << "ALT A-Star Tests Passed: " << passed_count << "/6\n\n";
+}
+
+/*
+Bidirectional BFS and A* (Using Simple Data)
+    Algorithms Complete
+    Paths Generated between start and goal
+    Bidirectional A* path costs the same as the A* path
+    A start that is also the goal meets at once
+*/
+void test_bidirectional_simple(){
+    auto m = get_simple_map();
+    auto g = MapData::get_graph_from_map(m);
+    g.root = SIMPLE_ROOT;
+    g.end = SIMPLE_END;
+    auto bi_as = BidirectionalAStar(g);
+    auto duration = timed_solve(bi_as, g);
+    auto results = bi_as.reconstruct_path(g.root, g.end);
+
+    auto bi_bfs = BidirectionalBFS(g);
+    bi_bfs.solve(g.root, g.end, COMPUTE_TIMEOUT);
+    auto bfs_results = bi_bfs.reconstruct_path(g.root, g.end);
+
+    // Test component
+    int passed_count = 0;
+    cout << "BIDIRECTIONAL TESTS\n";
+    cout << "\tTest Start Point: ";
+    test_valid_node(g, g.root, passed_count);
+    cout << "\tTest End Point: ";
+    test_valid_node(g, g.end, passed_count);
+    cout << "\tTest Speed: ";
+    test_speed(duration, 10, passed_count);
+    cout << "\tTest Path: ";
+    test_path_rmse(results.first, passed_count);
+    cout << "\tTest Same Distance as A*: ";
+    test_same_dist(results.second, get_a_star_dist(g, g.root, g.end), passed_count);
+    cout << "\tTest BFS Path: ";
+    test_valid_path(g, bfs_results.first, bfs_results.second, passed_count);
+
+    cout << "\tTest Invalid Point: ";
+    test_invalid_node(g, {0,0}, passed_count);
+    cout << "\tTest Same Start and Goal: ";
+    auto same_as = BidirectionalAStar(g);
+    same_as.solve(g.root, g.root, COMPUTE_TIMEOUT);
+    auto same_bfs = BidirectionalBFS(g);
+    same_bfs.solve(g.root, g.root, COMPUTE_TIMEOUT);
+    auto same = same_as.reconstruct_path(g.root, g.root), same_bfs_results = same_bfs.reconstruct_path(g.root, g.root);
+    if(same.second == 0 && same.first == vector<cell>{g.root} && same_bfs_results.first == vector<cell>{g.root}){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, distance from start to itself is " << same.second << endl;
+    cout << "Bidirectional Tests Passed: " << passed_count << "/8\n\n";
+}
+
+/*
+ARA* (Using Simple Data)
+    Paths Generated between start and goal
+    Every path is within its suboptimality bound
+    Last path costs the same as the A* path
+    Each published path lowers the weight and is no longer than the last
+    Invalid goal is rejected
+*/
+void test_ara_star_simple(){
+    auto m = get_simple_map();
+    auto g = MapData::get_graph_from_map(m);
+    g.root = SIMPLE_ROOT;
+    g.end = SIMPLE_END;
+    auto ara = ARAStar(g, 3, 0.5);
+    auto duration = timed_solve(ara, g);
+    float dist = ara.reconstruct_path(g.root, g.end).second;
+    float a_star_dist = get_a_star_dist(g, g.root, g.end);
+
+    // Test component
+    int passed_count = 0;
+    cout << "ARA-STAR TESTS\n";
+    cout << "\tTest Speed: ";
+    test_speed(duration, 10, passed_count);
+    cout << "\tTest Paths: ";
+    bool connected = !ara.get_solutions().empty();
+    for(auto s: ara.get_solutions()) connected = connected && is_valid_path(g, s.path, g.root, g.end, s.dist);
+    if(connected){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, a path is not connected or does not cost its distance\n";
+    cout << "\tTest Bounds: ";
+    bool bounded = true;
+    for(auto s: ara.get_solutions()) bounded = bounded && s.bound >= 1 && s.bound <= s.weight && s.dist <= s.bound*a_star_dist;
+    if(bounded){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, a path is longer than its bound allows\n";
+    cout << "\tTest Same Distance as A*: ";
+    test_same_dist(dist, a_star_dist, passed_count);
+    cout << "\tTest Improving Paths: ";
+    auto solutions = ara.get_solutions();
+    bool improving = solutions.size() > 1 && solutions.back().weight == 1;
+    for(size_t i = 1; i < solutions.size(); i++){
+        improving = improving && solutions[i].weight < solutions[i-1].weight && solutions[i].dist <= solutions[i-1].dist;
+    }
+    if(improving){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, " << solutions.size() << " paths do not lower the weight down to 1 without getting longer\n";
+
+    cout << "\tTest Invalid Point: ";
+    test_invalid_node(g, {0,0}, passed_count);
+    cout << "\tTest Invalid Goal: ";
+    auto invalid = ARAStar(g);
+    invalid.solve(g.root, {-5, -5}, COMPUTE_TIMEOUT);
+    if(!invalid.goal_reached && invalid.get_solutions().empty()){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, found a path to (-5,-5)\n";
+    cout << "ARA-Star Tests Passed: " << passed_count << "/7\n\n";
+}
+
+/*
+Contraction Hierarchy (Using Simple Data)
+    Path Generated between start and goal
+    Path only uses valid moves
+    Path costs the same as the A* path
+    Paths between a spread of other cells cost the same as A*
+    Serialized hierarchy gives the same distance
+    Queries inside one rectangle are answered directly
+*/
+void test_contraction_hierarchy_simple(){
+    auto m = get_simple_map();
+    auto g = GridGraph(m);
+    g.root = SIMPLE_ROOT;
+    g.end = SIMPLE_END;
+
+    // Timed with the preprocessing, which dominates on the simple map
+    auto start_time = get_time("Start Time"); 
+    auto ch = make_shared<const ContractionHierarchy>(g);
+    auto search = CHSearch(g, ch);
+    search.solve(g.root, g.end, COMPUTE_TIMEOUT);
+    auto end_time = get_time("End Time"); 
+    auto duration = duration_cast<milliseconds>(end_time- start_time);
+    auto results = search.reconstruct_path(g.root, g.end);
+    float dist = results.second;
+
+    // Test component
+    int passed_count = 0;
+    cout << "CONTRACTION HIERARCHY TESTS\n";
+    cout << "\tTest Speed: ";
+    test_speed(duration, 10, passed_count);
+    cout << "\tTest Path: ";
+    test_valid_path(g, results.first, dist, passed_count);
+    cout << "\tTest Same Distance as A*: ";
+    test_same_dist(dist, get_a_star_dist(g, g.root, g.end), passed_count);
+    cout << "\tTest Other Queries: ";
+    // Shortcuts are only exact if every pair is, so check a spread of them
+    auto nodes = g.get_nodes();
+    bool exact = true;
+    for(size_t i = 0; exact && i < nodes.size(); i += 5){
+        for(size_t j = 0; exact && j < nodes.size(); j += 11){
+            auto pair_search = CHSearch(g, ch);
+            pair_search.solve(nodes[i], nodes[j], COMPUTE_TIMEOUT);
+            auto pair_results = pair_search.reconstruct_path(nodes[i], nodes[j]);
+            float pair_a_star_dist = get_a_star_dist(g, nodes[i], nodes[j]);
+            exact = pair_results.second == pair_a_star_dist &&
+                    (!pair_search.goal_reached || is_valid_path(g, pair_results.first, nodes[i], nodes[j], pair_results.second));
+            if(!exact) cout << "failed, distance from (" << nodes[i].first << "," << nodes[i].second << ") to (" << nodes[j].first << ","
+                            << nodes[j].second << ") is " << pair_results.second << " (A* distance is " << pair_a_star_dist << ")\n";
+        }
+    }
+    if(exact){
+        cout << "passed\n";
+        passed_count++;
+    }
+    cout << "\tTest Serialization: ";
+    auto data = ch->serialize();
+    auto loaded = ContractionHierarchy::deserialize(data.data(), data.size(), g);
+    float loaded_dist = -1;
+    if(loaded){
+        auto loaded_search = CHSearch(g, loaded);
+        loaded_search.solve(g.root, g.end, COMPUTE_TIMEOUT);
+        loaded_dist = loaded_search.reconstruct_path(g.root, g.end).second;
+    }
+    if(loaded_dist == dist && loaded->get_num_nodes() == ch->get_num_nodes() &&
+       !ContractionHierarchy::deserialize(data.data(), data.size()-1, g)){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, loaded hierarchy does not match\n";
+    cout << "\tTest Same Rectangle: ";
+    search.solve(g.root, g.root, COMPUTE_TIMEOUT);
+    auto same = search.reconstruct_path(g.root, g.root);
+    if(search.goal_reached && same.second == 0 && same.first == vector<cell>{g.root}){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, distance from start to itself is " << same.second << endl;
+    cout << "Contraction Hierarchy Tests Passed: " << passed_count << "/6\n\n";
+}
+
+/*
+HPA* (Using Simple Data)
+    Path Generated between start and goal
+    Path only uses valid moves
+    Path costs at most 1.5 times the A* path
+    Unreachable goals are reported
+    Rebuilding the edited clusters matches a fresh abstraction
+*/
+void test_hpa_star_simple(){
+    auto m = get_simple_map();
+    auto g = GridGraph(m);
+    g.root = SIMPLE_ROOT;
+    g.end = SIMPLE_END;
+
+    // Small clusters so the simple map is split into several of them
+    int cluster_size = 5;
+    auto start_time = get_time("Start Time"); 
+    auto hpa = HPAStar(g, cluster_size);
+    hpa.solve(g.root, g.end, COMPUTE_TIMEOUT);
+    auto end_time = get_time("End Time"); 
+    auto duration = duration_cast<milliseconds>(end_time- start_time);
+    auto results = hpa.reconstruct_path(g.root, g.end);
+    float dist = results.second;
+    float a_star_dist = get_a_star_dist(g, g.root, g.end);
+
+    // Test component
+    float dist_ratio = 1.5;
+    int passed_count = 0;
+    cout << "HPA-STAR TESTS\n";
+    cout << "\tTest Speed: ";
+    test_speed(duration, 10, passed_count);
+    cout << "\tTest Path: ";
+    test_valid_path(g, results.first, dist, passed_count);
+    cout << "\tTest Distance Bound: ";
+    if(dist >= a_star_dist && dist <= dist_ratio*a_star_dist){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, distance is " << dist << " (A* distance is " << a_star_dist << ")\n";
+
+    // Wall off the goal, then rebuild only the edited clusters
+    vector<CellRect> rects;
+    for(int x = g.end.first-1; x <= g.end.first+1; x++){
+        for(int y = g.end.second-1; y <= g.end.second+1; y++){
+            if(cell(x, y) == g.end) continue;
+            m.boundaries[y][x] = OBSTACLE_INT;
+            MapData::mark_dirty(m, MapData::point_rect(m, {x, y}, 1));
+        }
+    }
+    MapData::get_dirty_rects(m, hpa.get_map_version(), rects);
+    g.update(m);
+    int rebuilt = hpa.update_graph(g, rects);
+    hpa.solve(g.root, g.end, COMPUTE_TIMEOUT);
+    cout << "\tTest Unreachable Goal: ";
+    if(!hpa.goal_reached && hpa.reconstruct_path(g.root, g.end).first.empty()){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, found a path to a walled-off goal\n";
+    cout << "\tTest Cluster Update: ";
+    auto fresh = HPAStar(g, cluster_size);
+    if(rebuilt > 0 && rebuilt < hpa.get_num_clusters() && fresh.get_num_entrances() == hpa.get_num_entrances()){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, rebuilt " << rebuilt << " of " << hpa.get_num_clusters() << " clusters with "
+              << hpa.get_num_entrances() << " entrances (fresh build has " << fresh.get_num_entrances() << ")\n";
+    cout << "HPA-Star Tests Passed: " << passed_count << "/5\n\n";
+}
+
+/*
+Pyramid Search (Using Simple Data)
+    Path Generated between start and goal
+    Path only uses valid moves
+    Path costs at most 1.5 times the A* path
+    Coarse cells are free only if all of their children are
+    Invalid start is rejected
+    Searches share the pyramid until the map is edited
+*/
+void test_pyramid_search_simple(){
+    auto m = get_simple_map();
+    auto g = GridGraph(m);
+    g.root = SIMPLE_ROOT;
+    g.end = SIMPLE_END;
+
+    // Small top level so the simple map gets several levels
+    int min_size = 4;
+    auto start_time = get_time("Start Time"); 
+    auto ps = PyramidSearch(g, min_size);
+    ps.solve(g.root, g.end, COMPUTE_TIMEOUT);
+    auto end_time = get_time("End Time"); 
+    auto duration = duration_cast<milliseconds>(end_time- start_time);
+    auto results = ps.reconstruct_path(g.root, g.end);
+    float dist = results.second;
+    float a_star_dist = get_a_star_dist(g, g.root, g.end);
+
+    // Test component
+    float dist_ratio = 1.5;
+    int passed_count = 0;
+    cout << "PYRAMID SEARCH TESTS\n";
+    cout << "\tTest Speed: ";
+    test_speed(duration, 10, passed_count);
+    cout << "\tTest Path: ";
+    test_valid_path(g, results.first, dist, passed_count);
+    cout << "\tTest Distance Bound: ";
+    if(dist >= a_star_dist && dist <= dist_ratio*a_star_dist){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, distance is " << dist << " (A* distance is " << a_star_dist << ")\n";
+    cout << "\tTest Conservative Pyramid: ";
+    auto levels = MapData::get_occupancy_pyramid(g.get_free_bitmap(), min_size);
+    bool conservative = levels.size() > 1 && (int)levels.size() == ps.get_num_levels();
+    for(size_t k = 1; k < levels.size(); k++){
+        auto& fine = levels[k-1];
+        for(int row = 0; row < fine.get_height(); row++){
+            for(int col = 0; col < fine.get_width(); col++){
+                if(levels[k].is_free(col/2, row/2) && !fine.is_free(col, row)) conservative = false;
+            }
+        }
+    }
+    if(conservative){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, a coarse cell is free over a blocked cell\n";
+    cout << "\tTest Invalid Point: ";
+    ps.solve({0,0}, g.end, COMPUTE_TIMEOUT);
+    if(!ps.goal_reached && ps.reconstruct_path({0,0}, g.end).first.empty()){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, found a path from (0,0)\n";
+    cout << "\tTest Shared Pyramid: ";
+    auto shared = PyramidSearch::get_pyramid(g, min_size);
+    bool reused = shared == PyramidSearch::get_pyramid(g, min_size);
+    cell blocked = g.get_nodes().front();
+    m.boundaries[blocked.second][blocked.first] = OBSTACLE_INT;
+    MapData::mark_dirty(m, MapData::point_rect(m, blocked, 1));
+    g.update(m);
+    auto rebuilt = PyramidSearch::get_pyramid(g, min_size);
+    if(reused && rebuilt != shared && !(*rebuilt)[0].is_free(blocked.first, blocked.second)){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, pyramid was " << (reused ? "not rebuilt after an edit\n" : "rebuilt without an edit\n");
+    cout << "Pyramid Search Tests Passed: " << passed_count << "/6\n\n";
+}
+
+/*
+Cost-to-Go Field (Using Simple Data)
+    Field and first query take less than 10 ms
+    Paths from several starts cost the same as A*
+    Paths only use valid moves
+    Second query to the same goal reuses the cached field
+    Least recently used field is evicted over the memory budget
+    Invalid start is rejected
+    Editing the map builds a new field
+*/
+void test_cost_to_go_simple(){
+    auto m = get_simple_map();
+    auto g = GridGraph(m);
+    g.root = SIMPLE_ROOT;
+    g.end = SIMPLE_END;
+
+    auto cache = make_shared<CostToGoCache>();
+    auto search = CostToGoSearch(g, cache);
+    auto duration = timed_solve(search, g);
+    auto field = search.get_field();
+
+    // Every 7th free cell is a start
+    vector<cell> starts;
+    auto nodes = g.get_nodes();
+    for(size_t i = 0; i < nodes.size(); i += 7) starts.push_back(nodes[i]);
+
+    // Test component
+    int passed_count = 0;
+    cout << "COST-TO-GO TESTS\n";
+    cout << "\tTest Speed: ";
+    test_speed(duration, 10, passed_count);
+    cout << "\tTest Same Distance as A*: ";
+    bool same = search.goal_reached;
+    bool valid = true;
+    for(auto sp: starts){
+        auto results = field->descend(g, sp);
+        float a_star_dist = get_a_star_dist(g, sp, g.end);
+        if(results.second != a_star_dist){
+            cout << "failed, distance from (" << sp.first << "," << sp.second << ") is " << results.second
+                 << " (A* distance is " << a_star_dist << ")\n";
+            same = false;
+            break;
+        }
+        if(!results.first.empty()) valid = valid && is_valid_path(g, results.first, sp, g.end, results.second);
+    }
+    if(same){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else if(!search.goal_reached) cout << "failed, no path from (" << g.root.first << "," << g.root.second << ")\n";
+    cout << "\tTest Path: ";
+    if(valid && !starts.empty()){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, a path is not connected or does not cost its distance\n";
+    cout << "\tTest Cache Reuse: ";
+    auto again = CostToGoSearch(g, cache);
+    again.solve(starts.front(), g.end, COMPUTE_TIMEOUT);
+    if(again.get_field() == field && cache->get_hits() == 1 && cache->get_misses() == 1){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, " << cache->get_hits() << " hits and " << cache->get_misses() << " misses (expected 1 and 1)\n";
+    cout << "\tTest LRU Eviction: ";
+    // Room for two fields: the field of g.root is evicted since g.end was used after it
+    auto lru = CostToGoCache(2*field->get_memory());
+    lru.get_field(g, g.end);
+    lru.get_field(g, g.root);
+    lru.get_field(g, g.end);
+    lru.get_field(g, starts.front());
+    int misses = lru.get_misses();
+    lru.get_field(g, g.end);
+    bool kept = lru.get_misses() == misses;
+    lru.get_field(g, g.root);
+    bool evicted = lru.get_misses() == misses+1;
+    if(kept && evicted && lru.get_num_fields() == 2 && lru.get_memory_used() <= lru.get_memory_budget()){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, " << lru.get_num_fields() << " fields using " << lru.get_memory_used() << " of "
+              << lru.get_memory_budget() << " bytes\n";
+    cout << "\tTest Invalid Point: ";
+    again.solve({0,0}, g.end, COMPUTE_TIMEOUT);
+    if(!again.goal_reached && again.reconstruct_path({0,0}, g.end).first.empty() && field->descend(g, {0,0}).first.empty()){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, found a path from (0,0)\n";
+    cout << "\tTest Map Change: ";
+    // Fields are keyed by map version, so an edit builds a new one
+    m.boundaries[5][6] = OBSTACLE_INT;
+    MapData::mark_dirty(m, MapData::point_rect(m, {6, 5}, 1));
+    g.update(m);
+    auto edited = CostToGoSearch(g, cache);
+    edited.solve(g.root, g.end, COMPUTE_TIMEOUT);
+    auto detour = edited.reconstruct_path(g.root, g.end);
+    float detour_dist = get_a_star_dist(g, g.root, g.end);
+    if(edited.get_field() != field && detour.second == detour_dist && is_valid_path(g, detour.first, g.root, g.end, detour.second)){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, distance after the edit is " << detour.second << " (A* distance is " << detour_dist << ")\n";
+    cout << "Cost-to-Go Tests Passed: " << passed_count << "/7\n\n";
+}
+
+/*
+D* Lite (Using Simple Data)
     Algorithm Completes
     Path Generated between start and goal
     Duration is less than 2 minutes
+    Replanned path matches Dijkstra after blocking a cell
 */
-/*void test_d_star_lite_simple(){
+void test_d_star_lite_simple(){
     auto m = get_simple_map();
     //m.boundaries = MapData::inflate_boundaries(m, 3);
     auto g = MapData::get_graph_from_map(m);
@@ -625,7 +1694,7 @@ D* (Using Simple Data)
     auto ds = DStarLite(g);
 
     auto start_time = get_time("Start Time"); 
-    ds.solve(g.root, g.end);
+    ds.solve(g.root, g.end, 10000);
     auto end_time = get_time("End Time"); 
     auto duration = duration_cast<milliseconds>(end_time- start_time);
 
@@ -665,13 +1734,35 @@ D* (Using Simple Data)
         passed_count++;
     }
     else cout << "failed, distance is greater than " << dist_limit << endl;
-    auto nm = MapData::add_path_to_map(m, path);
-    MapData::show_map("D* Lite", nm);
+
+    // Block a cell on the path, repair and compare with planning from scratch
+    auto gg = GridGraph(m);
+    auto replanner = DStarLite(gg);
+    replanner.solve(g.root, g.end, 10000);
+    cell blocked = {8,5};
+    m.boundaries[blocked.second][blocked.first] = OBSTACLE_INT;
+    MapData::mark_dirty(m, MapData::point_rect(m, blocked, 1));
+    vector<CellRect> rects;
+    MapData::get_dirty_rects(m, replanner.get_map_version(), rects);
+    gg.update(m);
+    replanner.update_graph(gg, rects);
+    replanner.solve(g.root, g.end, 10000);
+    auto replan = replanner.reconstruct_path(g.root, g.end);
+    auto dijkstra = Dijkstra(gg);
+    dijkstra.solve(g.root, g.end, 10000);
+    float scratch_dist = dijkstra.reconstruct_path(g.root, g.end).second;
+    bool avoids_block = std::find(replan.first.begin(), replan.first.end(), blocked) == replan.first.end();
+    cout << "\tTest Replan: ";
+    if(!replan.first.empty() && avoids_block && replan.second == scratch_dist){
+        cout << "passed\n";
+        passed_count++;
+    }
+    else cout << "failed, distance is " << replan.second << " (Dijkstra distance is " << scratch_dist << ")\n";
 
     cout << "\tTest Invalid Point: ";
     test_invalid_node(g, {0,0}, passed_count);
-    cout << "D-Star-Lite Tests Passed: " << passed_count << "/6\n\n";
-}*/
+    cout << "D-Star-Lite Tests Passed: " << passed_count << "/7\n\n";
+}
 
 /*
 RRT* (Using Simple Data)
@@ -763,6 +1854,16 @@ int main(){
     test_conversions();
     test_bfs_simple();
     test_a_star_simple();
-    //test_d_star_lite_simple();
+    test_dijkstra_simple();
+    test_jps_simple();
+    test_adaptive_a_star_simple();
+    test_alt_a_star_simple();
+    test_bidirectional_simple();
+    test_ara_star_simple();
+    test_contraction_hierarchy_simple();
+    test_hpa_star_simple();
+    test_pyramid_search_simple();
+    test_cost_to_go_simple();
+    test_d_star_lite_simple();
     test_rrt_star_simple();
 }